@@ -1,7 +1,13 @@
 #include "Application.h"
+#include "classes/EventLog.h"
+#include "classes/LogConsoleView.h"
 #include "classes/Logger.h"
+#include "classes/Metrics.h"
+#include "classes/TextureCache.h"
 #include "classes/TicTacToe.h"
+#include "classes/Trace.h"
 #include "imgui/imgui.h"
+#include <chrono>
 
 namespace ClassGame {
 //
@@ -11,10 +17,49 @@ TicTacToe *game = nullptr;
 bool gameOver = false;
 int gameWinner = -1;
 
+// sleep between inputs while nothing changes, see NeedsRedraw
+static bool powerSaving = true;
+
+// when GameStartUp began, for the time-to-first-frame report
+static std::chrono::steady_clock::time_point startupTime;
+static bool firstFrameReported = false;
+
+//
+// Append a game-level record (no move) to the binary event log
+//
+static void RecordGameEvent(GameEventId id, int player) {
+  GameEventRecord record;
+  record.id = id;
+  record.player = (int8_t)player;
+  record.board = game->getBoard().key();
+  EventLog::GetInstance().Record(record);
+}
+
+//
+// Text color for each log level in the console
+//
+static ImVec4 LogLevelColor(LogLevel level) {
+  switch (level) {
+  case LogLevel::INFO:
+    return ImVec4(1.0f, 1.0f, 1.0f, 1.0f); // White
+  case LogLevel::WARNING:
+    return ImVec4(1.0f, 1.0f, 0.0f, 1.0f); // Yellow
+  case LogLevel::ERROR:
+    return ImVec4(1.0f, 0.4f, 0.4f, 1.0f); // Red
+  case LogLevel::DEBUG:
+    return ImVec4(0.6f, 0.6f, 0.6f, 1.0f); // Gray
+  case LogLevel::GAME_EVENT:
+    return ImVec4(0.4f, 1.0f, 0.4f, 1.0f); // Green
+  default:
+    return ImVec4(1.0f, 1.0f, 1.0f, 1.0f);
+  }
+}
+
 //
 // Helper function to render the Logger window
 //
 void RenderLoggerWindow() {
+  TRACE_SCOPE("RenderLoggerWindow");
   ImGui::Begin("Log Console");
 
   // Control buttons
@@ -25,42 +70,71 @@ void RenderLoggerWindow() {
   static bool autoScroll = true;
   ImGui::Checkbox("Auto-scroll", &autoScroll);
 
+  // Least severe level that is still recorded
+  static int minLevel = 0;
+  const LogLevel levels[] = {LogLevel::DEBUG, LogLevel::INFO,
+                             LogLevel::GAME_EVENT, LogLevel::WARNING,
+                             LogLevel::ERROR};
+  const char *levelNames[] = {"Debug", "Info", "Game", "Warning", "Error"};
+  ImGui::SameLine();
+  ImGui::SetNextItemWidth(100.0f);
+  if (ImGui::Combo("Min level", &minLevel, levelNames,
+                   IM_ARRAYSIZE(levelNames))) {
+    Logger::GetInstance().SetMinLevel(levels[minLevel]);
+  }
+
+  ImGui::Separator();
+
+  // Which entries to show: level toggles plus a text or regex filter
+  static LogConsoleView view;
+  const char *levelLabels[] = {"Info", "Warn", "Error", "Debug", "Game"};
+  for (int level = 0; level < LOG_LEVEL_COUNT; level++) {
+    bool enabled = view.IsLevelEnabled((LogLevel)level);
+    if (level > 0) {
+      ImGui::SameLine();
+    }
+    if (ImGui::Checkbox(levelLabels[level], &enabled)) {
+      view.SetLevelEnabled((LogLevel)level, enabled);
+    }
+  }
+  static char filterText[256] = "";
+  static bool filterRegex = false;
+  static bool filterValid = true;
+  ImGui::SetNextItemWidth(200.0f);
+  bool filterChanged =
+      ImGui::InputTextWithHint("##filter", "Filter", filterText,
+                               IM_ARRAYSIZE(filterText));
+  ImGui::SameLine();
+  filterChanged |= ImGui::Checkbox("Regex", &filterRegex);
+  if (filterChanged) {
+    filterValid = view.SetTextFilter(filterText, filterRegex);
+  }
+  ImGui::SameLine();
+  if (filterValid) {
+    ImGui::Text("%zu / %zu", view.GetMatchCount(), view.GetEntryCount());
+  } else {
+    ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "invalid regex");
+  }
+
   ImGui::Separator();
 
   // Log entries display
   ImGui::BeginChild("LogScrollRegion", ImVec2(0, 0), false,
                     ImGuiWindowFlags_HorizontalScrollbar);
 
-  const auto &logs = Logger::GetInstance().GetLogEntries();
-  for (const auto &entry : logs) {
-    // Color based on log level
-    ImVec4 color;
-    switch (entry.level) {
-    case LogLevel::INFO:
-      color = ImVec4(1.0f, 1.0f, 1.0f, 1.0f); // White
-      break;
-    case LogLevel::WARNING:
-      color = ImVec4(1.0f, 1.0f, 0.0f, 1.0f); // Yellow
-      break;
-    case LogLevel::ERROR:
-      color = ImVec4(1.0f, 0.4f, 0.4f, 1.0f); // Red
-      break;
-    case LogLevel::DEBUG:
-      color = ImVec4(0.6f, 0.6f, 0.6f, 1.0f); // Gray
-      break;
-    case LogLevel::GAME_EVENT:
-      color = ImVec4(0.4f, 1.0f, 0.4f, 1.0f); // Green
-      break;
-    default:
-      color = ImVec4(1.0f, 1.0f, 1.0f, 1.0f);
+  // Only new entries are indexed each frame and only the rows in view are
+  // submitted, each entry's text is formatted once when it is logged
+  view.Update(Logger::GetInstance());
+  ImGuiListClipper clipper;
+  clipper.Begin((int)view.GetMatchCount());
+  while (clipper.Step()) {
+    for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+      const LogEntry &entry = view.GetMatch((size_t)i);
+      const std::string &line = entry.displayLine;
+      ImGui::PushStyleColor(ImGuiCol_Text, LogLevelColor(entry.level));
+      ImGui::TextUnformatted(line.data(), line.data() + line.size());
+      ImGui::PopStyleColor();
     }
-
-    ImGui::PushStyleColor(ImGuiCol_Text, color);
-    ImGui::TextUnformatted(
-        ("[" + Logger::GetInstance().GetLogLevelString(entry.level) + "] " +
-         entry.timestamp + ": " + entry.message)
-            .c_str());
-    ImGui::PopStyleColor();
   }
 
   if (autoScroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY()) {
@@ -71,14 +145,107 @@ void RenderLoggerWindow() {
   ImGui::End();
 }
 
+//
+// Helper function to render the Metrics window
+//
+void RenderMetricsWindow() {
+  TRACE_SCOPE("RenderMetricsWindow");
+  ImGui::Begin("Metrics");
+  Metrics &metrics = Metrics::GetInstance();
+
+  // Prometheus text dumps, on demand or every few seconds
+  const char *dumpFile = "metrics.prom";
+  if (ImGui::Button("Dump now")) {
+    if (metrics.WritePrometheusFile(dumpFile)) {
+      LOG_INFO("Metrics written to {}", dumpFile);
+    } else {
+      LOG_ERROR("Could not write metrics to {}", dumpFile);
+    }
+  }
+  ImGui::SameLine();
+  bool periodic = !metrics.GetDumpFile().empty();
+  if (ImGui::Checkbox("Dump every 10 s", &periodic)) {
+    metrics.SetDumpFile(periodic ? dumpFile : "", 10000);
+  }
+
+  ImGui::Separator();
+
+  metrics.ForEachCounter([](const std::string &name, const Counter &counter) {
+    ImGui::Text("%-28s %llu", name.c_str(),
+                (unsigned long long)counter.Value());
+  });
+  metrics.ForEachGauge([](const std::string &name, const Gauge &gauge) {
+    ImGui::Text("%-28s %.2f", name.c_str(), gauge.Value());
+  });
+
+  ImGui::Separator();
+
+  if (ImGui::BeginTable("Histograms", 6,
+                        ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders)) {
+    ImGui::TableSetupColumn("Latency");
+    ImGui::TableSetupColumn("Count");
+    ImGui::TableSetupColumn("p50 us");
+    ImGui::TableSetupColumn("p90 us");
+    ImGui::TableSetupColumn("p99 us");
+    ImGui::TableSetupColumn("Max us");
+    ImGui::TableHeadersRow();
+    metrics.ForEachHistogram(
+        [](const std::string &name, const LatencyHistogram &histogram) {
+          ImGui::TableNextRow();
+          ImGui::TableNextColumn();
+          ImGui::TextUnformatted(name.c_str());
+          ImGui::TableNextColumn();
+          ImGui::Text("%llu", (unsigned long long)histogram.Count());
+          for (double p : {50.0, 90.0, 99.0}) {
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", (double)histogram.Percentile(p) / 1000.0);
+          }
+          ImGui::TableNextColumn();
+          ImGui::Text("%.1f", (double)histogram.Max() / 1000.0);
+        });
+    ImGui::EndTable();
+  }
+
+  ImGui::End();
+}
+
 //
 // game starting point
 // this is called by the main render loop in main.cpp
 //
 void GameStartUp() {
+  startupTime = std::chrono::steady_clock::now();
+
+  // every image under resources/ on a few shared pages, so a whole board
+  // draws from one texture. the build bakes them into resources.bundle;
+  // reading it (or decoding the PNGs on every core) starts right away and
+  // runs alongside the rest of startup.
+  TextureCache &textures = TextureCache::GetInstance();
+  textures.preloadAtlas("resources");
+
+  // keep file and console output off the game thread
+  Logger::GetInstance().SetAsyncMode(true);
+
+  // compact binary record of the game events, see tools/eventlog_decode.cpp
+  EventLog::GetInstance().Open("application.events");
+
   game = new TicTacToe();
+
+  // readiness barrier: the board's sprites point into the atlas, so it has
+  // to be resident before the board is set up and the first frame drawn.
+  // only the GPU uploads happen here, on the render thread.
+  int packed = textures.finishAtlas();
+  auto assetsTime = std::chrono::steady_clock::now() - startupTime;
+  LOG_INFO("Texture atlas: {} images on {} pages from {}, ready after {} us",
+           packed, textures.atlasPageCount(),
+           textures.atlasFromBundle() ? "resources.bundle" : "PNG files",
+           (long long)std::chrono::duration_cast<std::chrono::microseconds>(
+               assetsTime)
+               .count());
+
   game->setUpBoard();
-  Logger::GetInstance().LogInfo("Tic-Tac-Toe game started");
+  LOG_INFO("Tic-Tac-Toe game started");
+  RecordGameEvent(GameEventId::GAME_STARTED, -1);
 }
 
 //
@@ -86,6 +253,7 @@ void GameStartUp() {
 // this is called by the main render loop in main.cpp
 //
 void RenderGame() {
+  TRACE_SCOPE("RenderGame");
   ImGui::DockSpaceOverViewport();
 
   // ImGui::ShowDemoWindow();
@@ -95,6 +263,23 @@ void RenderGame() {
   if (!game->getCurrentPlayer())
     return;
 
+  // turn the AI last asked to move on, so it asks once per turn
+  static unsigned int lastAITurn = 0;
+
+  // a background AI move that finished since the last frame is played
+  // before anything else looks at the board
+  TicTacToe::AIMoveStatus aiMove = game->applyAIMove();
+  if (aiMove == TicTacToe::AIMoveStatus::Played) {
+    LOG_GAME_EVENT("AI made a move ({} nodes searched)",
+                   game->getLastSearchNodes());
+  } else if (aiMove == TicTacToe::AIMoveStatus::Discarded) {
+    // the answer didn't fit the board any more, ask again below
+    LOG_WARNING("Discarded a stale background AI move");
+    lastAITurn = 0;
+  }
+  // events recorded a while ago are written even if no new ones arrive
+  EventLog::GetInstance().FlushIfDue();
+
   ImGui::Begin("Settings");
   ImGui::Text("Current Player Number: %d",
               game->getCurrentPlayer()->playerNumber());
@@ -102,13 +287,38 @@ void RenderGame() {
 
   // AI toggle checkbox
   static bool aiEnabled = false;
-  static unsigned int lastAITurn = 0; // Track when AI last moved
   if (ImGui::Checkbox("Play vs AI", &aiEnabled)) {
     game->_gameOptions.AIPlaying = aiEnabled;
     game->_gameOptions.AIPlayer = 1; // AI plays as O (player 1)
     lastAITurn = 0;                  // Reset when toggling
-    Logger::GetInstance().LogInfo(aiEnabled ? "AI enabled (playing as O)"
-                                            : "AI disabled");
+    if (!aiEnabled) {
+      game->cancelAI();
+    }
+    LOG_INFO("AI {}", aiEnabled ? "enabled (playing as O)" : "disabled");
+  }
+
+  // run the search on a worker thread instead of inside this frame
+  static bool aiBackground = false;
+  if (ImGui::Checkbox("AI thinks in background", &aiBackground)) {
+    game->setAsyncAI(aiBackground);
+    lastAITurn = 0;
+    LOG_INFO("Background AI {}", aiBackground ? "enabled" : "disabled");
+  }
+
+  // AI search selection
+  static int searchMode = (int)game->getSearchMode();
+  const char *searchModes[] = {"Negamax", "Alpha-Beta", "Alpha-Beta + TT",
+                               "Perfect Table"};
+  if (ImGui::Combo("AI Search", &searchMode, searchModes,
+                   IM_ARRAYSIZE(searchModes))) {
+    game->setSearchMode((AISearchMode)searchMode);
+    LOG_INFO("AI search set to {}", searchModes[searchMode]);
+  }
+  if (game->getSearchMode() == AISearchMode::AlphaBetaTT) {
+    const TranspositionTable &table = game->getTranspositionTable();
+    ImGui::Text("TT hits: %llu  misses: %llu",
+                (unsigned long long)table.hits(),
+                (unsigned long long)table.misses());
   }
 
   // If AI is enabled and it's the AI's turn (player 1), make a move
@@ -116,10 +326,43 @@ void RenderGame() {
   unsigned int currentTurn = game->getCurrentTurnNo();
   if (aiEnabled && !gameOver && game->getCurrentPlayer()->playerNumber() == 1 &&
       lastAITurn != currentTurn) {
-    lastAITurn = currentTurn;
-    game->updateAI();
-    Logger::GetInstance().LogGameEvent("AI made a move");
-    EndOfTurn();
+    if (game->isAsyncAI()) {
+      // only a posted search counts as this turn's move
+      if (game->requestAIMove()) {
+        lastAITurn = currentTurn;
+      }
+    } else {
+      lastAITurn = currentTurn;
+      game->updateAI();
+      LOG_GAME_EVENT("AI made a move ({} nodes searched)",
+                     game->getLastSearchNodes());
+      EndOfTurn();
+    }
+  }
+  if (game->isAIThinking()) {
+    ImGui::Text("AI is thinking...");
+  }
+
+  // stop redrawing at full rate while the board and log are still
+  ImGui::Checkbox("Power saving when idle", &powerSaving);
+
+  // Chrome trace of the frame and AI phases, open it in ui.perfetto.dev
+  Tracer &tracer = Tracer::GetInstance();
+  const char *traceFile = "application.trace.json";
+  bool tracing = tracer.IsRecording();
+  if (ImGui::Checkbox("Record trace", &tracing)) {
+    if (tracing) {
+      tracer.Start(traceFile);
+      LOG_INFO("Trace recording started");
+    } else if (tracer.Stop()) {
+      LOG_INFO("Trace written to {}", traceFile);
+    } else {
+      LOG_ERROR("Could not write trace to {}", traceFile);
+    }
+  }
+  if (tracing) {
+    ImGui::SameLine();
+    ImGui::Text("%zu spans", tracer.GetEventCount());
   }
 
   // Always-visible Reset Game button
@@ -129,7 +372,9 @@ void RenderGame() {
     gameOver = false;
     gameWinner = -1;
     lastAITurn = 0;
-    Logger::GetInstance().LogInfo("Game reset");
+    LOG_INFO("Game reset");
+    RecordGameEvent(GameEventId::GAME_RESET, -1);
+    EventLog::GetInstance().Flush();
   }
 
   if (gameOver) {
@@ -147,8 +392,37 @@ void RenderGame() {
   game->drawFrame();
   ImGui::End();
 
+  if (!firstFrameReported) {
+    firstFrameReported = true;
+    auto elapsed = std::chrono::steady_clock::now() - startupTime;
+    Metrics::GetInstance()
+        .GetGauge("startup_first_frame_seconds",
+                  "Time from GameStartUp to the first frame with the board")
+        .Set(std::chrono::duration<double>(elapsed).count());
+    LOG_INFO("Time to first frame: {} us",
+             (long long)std::chrono::duration_cast<std::chrono::microseconds>(
+                 elapsed)
+                 .count());
+  }
+
   // Render the Logger window
   RenderLoggerWindow();
+  RenderMetricsWindow();
+}
+
+//
+// asked by the render loop after every frame. a board change, a new log line
+// or a running background search all need more frames; input is noticed by
+// the loop itself.
+//
+bool NeedsRedraw() {
+  // take every flag each time, so a change isn't reported twice
+  bool dirty = Logger::GetInstance().TakeDirty();
+  if (game) {
+    dirty |= game->takeDirty();
+    dirty |= game->isAIThinking();
+  }
+  return dirty || !powerSaving;
 }
 
 //
@@ -156,18 +430,29 @@ void RenderGame() {
 // this is where we check for a winner
 //
 void EndOfTurn() {
+  // the sync AI path reports the same turn twice, only record the first
+  bool alreadyOver = gameOver;
   Player *winner = game->checkForWinner();
   if (winner) {
     gameOver = true;
     gameWinner = winner->playerNumber();
-    Logger::GetInstance().LogGameEvent("Winner: Player " +
-                                       std::to_string(gameWinner) +
-                                       (gameWinner == 0 ? " (X)" : " (O)"));
+    LOG_GAME_EVENT("Winner: Player {} ({})", gameWinner,
+                   gameWinner == 0 ? "X" : "O");
+    if (!alreadyOver) {
+      RecordGameEvent(GameEventId::GAME_WON, gameWinner);
+    }
   }
   if (game->checkForDraw()) {
     gameOver = true;
     gameWinner = -1;
-    Logger::GetInstance().LogGameEvent("Game ended in a draw");
+    LOG_GAME_EVENT("Game ended in a draw");
+    if (!alreadyOver) {
+      RecordGameEvent(GameEventId::GAME_DRAWN, -1);
+    }
+  }
+  // a finished game goes to disk straight away
+  if (gameOver && !alreadyOver) {
+    EventLog::GetInstance().Flush();
   }
 }
 } // namespace ClassGame
@@ -4,4 +4,7 @@ namespace ClassGame {
     void GameStartUp();
     void RenderGame();
     void EndOfTurn();
+    // true while something on screen can still change without input, the
+    // render loop keeps drawing until it says false and then waits for input
+    bool NeedsRedraw();
 }
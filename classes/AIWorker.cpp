@@ -0,0 +1,128 @@
+#include "AIWorker.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include <chrono>
+
+// transposition table slots for background searches
+const size_t AI_WORKER_TABLE_ENTRIES = 1 << 13;
+
+void recordAISearchMetrics(uint64_t nanoseconds, uint64_t nodes) {
+  static ClassGame::LatencyHistogram &searchTime =
+      ClassGame::Metrics::GetInstance().GetHistogram(
+          "ai_search_seconds", "Time for one AI move search");
+  static ClassGame::Counter &searchNodes =
+      ClassGame::Metrics::GetInstance().GetCounter(
+          "ai_search_nodes_total", "Positions visited by the AI search");
+  searchTime.Record(nanoseconds);
+  searchNodes.Add(nodes);
+}
+
+AIWorker::AIWorker()
+    : _hasPending(false), _running(false), _stop(false), _nextId(0),
+      _latestId(0), _hasResult(false), _resultId(0), _cancelSearch(false),
+      _table(AI_WORKER_TABLE_ENTRIES) {
+  _thread = std::thread(&AIWorker::run, this);
+}
+
+AIWorker::~AIWorker() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+    _hasPending = false;
+    _cancelSearch = true;
+  }
+  _wake.notify_one();
+  if (_thread.joinable()) {
+    _thread.join();
+  }
+}
+
+uint64_t AIWorker::post(const TicTacToeBoard &board, int player,
+                        AISearchMode mode, int maxDepth) {
+  uint64_t id;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    id = ++_nextId;
+    _latestId = id;
+    _pending.board = board;
+    _pending.player = player;
+    _pending.mode = mode;
+    _pending.maxDepth = maxDepth;
+    _pending.id = id;
+    _hasPending = true;
+    _hasResult = false;
+    if (_running) {
+      _cancelSearch = true;
+    }
+  }
+  _wake.notify_one();
+  return id;
+}
+
+bool AIWorker::poll(uint64_t jobId, AISearchResult &result) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (!_hasResult || _resultId != jobId) {
+    return false;
+  }
+  result = _result;
+  _hasResult = false;
+  return true;
+}
+
+void AIWorker::cancel() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _latestId = ++_nextId; // anything still running is now stale
+  _hasPending = false;
+  _hasResult = false;
+  if (_running) {
+    _cancelSearch = true;
+  }
+}
+
+bool AIWorker::busy() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _hasPending || _running;
+}
+
+void AIWorker::run() {
+  ClassGame::Tracer::GetInstance().SetThreadName("AI worker");
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true) {
+    _wake.wait(lock, [this] { return _stop || _hasPending; });
+    if (_stop) {
+      return;
+    }
+
+    Job job = _pending;
+    _hasPending = false;
+    _running = true;
+    _cancelSearch = false;
+    lock.unlock();
+
+    AISearchResult result;
+    std::chrono::steady_clock::duration elapsed;
+    {
+      TRACE_SCOPE("AIWorker search");
+      auto start = std::chrono::steady_clock::now();
+      result = searchBestMove(job.board, job.player, job.mode, &_table,
+                              &_cancelSearch, job.maxDepth);
+      elapsed = std::chrono::steady_clock::now() - start;
+    }
+    // a cancelled search stopped part way, its time would skew the histogram
+    if (!_cancelSearch) {
+      recordAISearchMetrics(
+          (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+              elapsed)
+              .count(),
+          result.nodes);
+    }
+
+    lock.lock();
+    _running = false;
+    if (job.id == _latestId && !_cancelSearch) {
+      _result = result;
+      _resultId = job.id;
+      _hasResult = true;
+    }
+  }
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "TicTacToeAI.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+// add one finished search to the ai_search_seconds / ai_search_nodes_total
+// metrics; called for searches on the main thread and on the worker alike
+void recordAISearchMetrics(uint64_t nanoseconds, uint64_t nodes);
+
+//
+// runs the tic-tac-toe search on a background thread so the render loop
+// never waits on it
+//
+// only plain position snapshots cross the thread boundary, the worker never
+// sees a Bit, Sprite or Player. the game posts a job, keeps rendering, and
+// polls for the result on a later frame.
+//
+class AIWorker {
+public:
+  AIWorker();
+  ~AIWorker();
+
+  AIWorker(const AIWorker &) = delete;
+  AIWorker &operator=(const AIWorker &) = delete;
+
+  // queue a search, replacing (and cancelling) anything already queued or
+  // running. returns the id to poll for.
+  uint64_t post(const TicTacToeBoard &board, int player, AISearchMode mode,
+                int maxDepth = 0);
+
+  // true, with result filled in, once the search for jobId has finished
+  bool poll(uint64_t jobId, AISearchResult &result);
+
+  // drop any queued or running search, its result will never be returned
+  void cancel();
+
+  // a search is queued or running
+  bool busy();
+
+private:
+  struct Job {
+    TicTacToeBoard board;
+    int player = 0;
+    AISearchMode mode = AISearchMode::AlphaBeta;
+    int maxDepth = 0;
+    uint64_t id = 0;
+  };
+
+  void run();
+
+  std::mutex _mutex;
+  std::condition_variable _wake;
+  std::thread _thread;
+
+  Job _pending;
+  bool _hasPending;
+  bool _running;
+  bool _stop;
+  uint64_t _nextId;
+  uint64_t _latestId;
+
+  bool _hasResult;
+  uint64_t _resultId;
+  AISearchResult _result;
+
+  // set to abandon the search in flight
+  std::atomic<bool> _cancelSearch;
+  // the worker's own table, only touched on the worker thread
+  TranspositionTable _table;
+};
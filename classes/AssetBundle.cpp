@@ -0,0 +1,263 @@
+#include "AssetBundle.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//
+// little-endian field helpers, the file layout doesn't depend on the host
+//
+static void putU16(unsigned char *out, uint16_t value)
+{
+    out[0] = (unsigned char)value;
+    out[1] = (unsigned char)(value >> 8);
+}
+
+static void putU32(unsigned char *out, uint32_t value)
+{
+    for (int i = 0; i < 4; i++) {
+        out[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+static void putU64(unsigned char *out, uint64_t value)
+{
+    for (int i = 0; i < 8; i++) {
+        out[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+static uint16_t getU16(const unsigned char *in)
+{
+    return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+static uint32_t getU32(const unsigned char *in)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        value |= (uint32_t)in[i] << (8 * i);
+    }
+    return value;
+}
+
+static uint64_t getU64(const unsigned char *in)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value |= (uint64_t)in[i] << (8 * i);
+    }
+    return value;
+}
+
+static size_t alignTo16(size_t offset)
+{
+    return (offset + 15) & ~(size_t)15;
+}
+
+bool AssetBundle::write(const std::string &filename, const TextureAtlas &atlas)
+{
+    const std::vector<AtlasPage> &pages = atlas.pages();
+    const std::unordered_map<std::string, AtlasRegion> &regions = atlas.regions();
+
+    size_t indexSize = ASSET_BUNDLE_HEADER_SIZE + pages.size() * ASSET_BUNDLE_PAGE_SIZE +
+                       regions.size() * ASSET_BUNDLE_IMAGE_SIZE;
+    std::vector<unsigned char> index(indexSize, 0);
+
+    unsigned char *out = index.data();
+    memcpy(out, "TTAB", 4);
+    putU16(out + 4, ASSET_BUNDLE_VERSION);
+    putU32(out + 8, (uint32_t)pages.size());
+    putU32(out + 12, (uint32_t)regions.size());
+    out += ASSET_BUNDLE_HEADER_SIZE;
+
+    std::vector<size_t> offsets;
+    size_t offset = alignTo16(indexSize);
+    for (const AtlasPage &page : pages) {
+        if (page.pixels.size() != (size_t)page.width * page.height * 4) {
+            return false;
+        }
+        putU32(out, (uint32_t)page.width);
+        putU32(out + 4, (uint32_t)page.height);
+        putU64(out + 8, offset);
+        out += ASSET_BUNDLE_PAGE_SIZE;
+        offsets.push_back(offset);
+        offset = alignTo16(offset + page.pixels.size());
+    }
+
+    // sorted so the same resources always bake to the same bytes
+    std::vector<std::string> names;
+    for (const auto &[name, region] : regions) {
+        if (name.size() >= ASSET_BUNDLE_NAME_SIZE) {
+            return false;
+        }
+        names.push_back(name);
+    }
+    std::sort(names.begin(), names.end());
+    for (const std::string &name : names) {
+        const AtlasRegion &region = regions.at(name);
+        memcpy(out, name.data(), name.size());
+        putU32(out + ASSET_BUNDLE_NAME_SIZE, (uint32_t)region.page);
+        putU16(out + ASSET_BUNDLE_NAME_SIZE + 4, (uint16_t)region.x);
+        putU16(out + ASSET_BUNDLE_NAME_SIZE + 6, (uint16_t)region.y);
+        putU16(out + ASSET_BUNDLE_NAME_SIZE + 8, (uint16_t)region.size.x);
+        putU16(out + ASSET_BUNDLE_NAME_SIZE + 10, (uint16_t)region.size.y);
+        out += ASSET_BUNDLE_IMAGE_SIZE;
+    }
+
+    std::ofstream file(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    const char padding[16] = {};
+    file.write((const char *)index.data(), (std::streamsize)index.size());
+    size_t written = index.size();
+    for (size_t i = 0; i < pages.size(); i++) {
+        file.write(padding, (std::streamsize)(offsets[i] - written));
+        file.write((const char *)pages[i].pixels.data(), (std::streamsize)pages[i].pixels.size());
+        written = offsets[i] + pages[i].pixels.size();
+    }
+    return file.good();
+}
+
+AssetBundle::~AssetBundle()
+{
+    close();
+}
+
+bool AssetBundle::open(const std::string &filename)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart < (LONGLONG)ASSET_BUNDLE_HEADER_SIZE) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    void *data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (!data) {
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        return false;
+    }
+    _file = file;
+    _mapping = mapping;
+    _data = (const unsigned char *)data;
+    _size = (size_t)size.QuadPart;
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)ASSET_BUNDLE_HEADER_SIZE) {
+        ::close(fd);
+        return false;
+    }
+    void *data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping keeps the file alive on its own
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    _data = (const unsigned char *)data;
+    _size = (size_t)info.st_size;
+#endif
+
+    if (!readIndex()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool AssetBundle::readIndex()
+{
+    const unsigned char *in = _data;
+    if (memcmp(in, "TTAB", 4) != 0 || getU16(in + 4) != ASSET_BUNDLE_VERSION) {
+        return false;
+    }
+    uint64_t pageCount = getU32(in + 8);
+    uint64_t imageCount = getU32(in + 12);
+    uint64_t indexSize = ASSET_BUNDLE_HEADER_SIZE + pageCount * ASSET_BUNDLE_PAGE_SIZE +
+                         imageCount * ASSET_BUNDLE_IMAGE_SIZE;
+    if (indexSize > _size) {
+        return false;
+    }
+    in += ASSET_BUNDLE_HEADER_SIZE;
+
+    for (uint64_t i = 0; i < pageCount; i++) {
+        AssetBundlePage page;
+        page.width = (int)getU32(in);
+        page.height = (int)getU32(in + 4);
+        uint64_t offset = getU64(in + 8);
+        uint64_t bytes = (uint64_t)getU32(in) * getU32(in + 4) * 4;
+        if (page.width <= 0 || page.height <= 0 || offset > _size || bytes > _size - offset) {
+            return false;
+        }
+        page.pixels = _data + offset;
+        _pages.push_back(page);
+        in += ASSET_BUNDLE_PAGE_SIZE;
+    }
+
+    for (uint64_t i = 0; i < imageCount; i++) {
+        const char *name = (const char *)in;
+        std::string imageName(name, strnlen(name, ASSET_BUNDLE_NAME_SIZE));
+        AtlasRegion region;
+        region.page = (int)getU32(in + ASSET_BUNDLE_NAME_SIZE);
+        region.x = getU16(in + ASSET_BUNDLE_NAME_SIZE + 4);
+        region.y = getU16(in + ASSET_BUNDLE_NAME_SIZE + 6);
+        int width = getU16(in + ASSET_BUNDLE_NAME_SIZE + 8);
+        int height = getU16(in + ASSET_BUNDLE_NAME_SIZE + 10);
+        if (region.page < 0 || region.page >= (int)_pages.size()) {
+            return false;
+        }
+        const AssetBundlePage &page = _pages[region.page];
+        if (region.x + width > page.width || region.y + height > page.height) {
+            return false;
+        }
+        region.size = ImVec2((float)width, (float)height);
+        region.uv0 = ImVec2((float)region.x / page.width, (float)region.y / page.height);
+        region.uv1 = ImVec2((float)(region.x + width) / page.width, (float)(region.y + height) / page.height);
+        _regions[imageName] = region;
+        in += ASSET_BUNDLE_IMAGE_SIZE;
+    }
+    return true;
+}
+
+void AssetBundle::close()
+{
+    if (_data) {
+#ifdef _WIN32
+        UnmapViewOfFile(_data);
+        CloseHandle((HANDLE)_mapping);
+        CloseHandle((HANDLE)_file);
+        _file = nullptr;
+        _mapping = nullptr;
+#else
+        munmap((void *)_data, _size);
+#endif
+    }
+    _data = nullptr;
+    _size = 0;
+    _pages.clear();
+    _regions.clear();
+}
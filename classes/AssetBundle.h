@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "TextureAtlas.h"
+
+//
+// prebaked image bundle: the resources/ atlas already decoded and packed at build time by
+// tools/assetbake.cpp, so startup maps one file and uploads its pages without inflating a PNG
+//
+// the file is little-endian:
+//
+//   header (16 bytes):     "TTAB", u16 version, u16 reserved, u32 page count, u32 image count
+//   page entry (16 bytes): u32 width, u32 height, u64 offset of the RGBA pixels in the file
+//   image entry (64 bytes): 48 byte nul-padded name, u32 page, u16 x, u16 y, u16 width,
+//                           u16 height (pixels on the page)
+//   pixels:                each page's rows, starting on a 16 byte boundary
+//
+
+const uint16_t ASSET_BUNDLE_VERSION = 1;
+const size_t ASSET_BUNDLE_HEADER_SIZE = 16;
+const size_t ASSET_BUNDLE_PAGE_SIZE = 16;
+const size_t ASSET_BUNDLE_IMAGE_SIZE = 64;
+const size_t ASSET_BUNDLE_NAME_SIZE = 48;
+
+// a page inside the mapped file, pixels stay valid until the bundle is closed
+struct AssetBundlePage
+{
+    int width = 0;
+    int height = 0;
+    const unsigned char *pixels = nullptr;
+};
+
+class AssetBundle
+{
+public:
+    AssetBundle() {}
+    ~AssetBundle();
+
+    AssetBundle(const AssetBundle &) = delete;
+    AssetBundle &operator=(const AssetBundle &) = delete;
+
+    // write a packed atlas out as a bundle
+    static bool write(const std::string &filename, const TextureAtlas &atlas);
+
+    // map a bundle and read its index. false, leaving the bundle closed, if the file is
+    // missing, from another version or cut short.
+    bool open(const std::string &filename);
+    void close();
+    bool isOpen() const { return _data != nullptr; }
+
+    const std::vector<AssetBundlePage> &pages() const { return _pages; }
+    // the UVs are worked out from the page sizes, same as TextureAtlas::build does
+    const std::unordered_map<std::string, AtlasRegion> &regions() const { return _regions; }
+
+private:
+    bool readIndex();
+
+    const unsigned char *_data = nullptr;
+    size_t _size = 0;
+#ifdef _WIN32
+    void *_file = nullptr;
+    void *_mapping = nullptr;
+#endif
+    std::vector<AssetBundlePage> _pages;
+    std::unordered_map<std::string, AtlasRegion> _regions;
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace ClassGame {
+
+//
+// Fixed-capacity multi-producer/multi-consumer queue (Vyukov's bounded
+// queue). Every slot carries a sequence number that tells producers and
+// consumers whose turn it is, so neither side ever takes a lock.
+//
+template <typename T> class BoundedQueue {
+public:
+  // capacity is rounded up to a power of two
+  explicit BoundedQueue(size_t capacity) : m_head(0), m_tail(0) {
+    size_t size = 2;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    m_mask = size - 1;
+    m_slots = std::make_unique<Slot[]>(size);
+    for (size_t i = 0; i < size; i++) {
+      m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  BoundedQueue(const BoundedQueue &) = delete;
+  BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+  // false if the queue is full, value is left untouched in that case
+  bool TryPush(T &&value) {
+    size_t pos = m_tail.load(std::memory_order_relaxed);
+    while (true) {
+      Slot &slot = m_slots[pos & m_mask];
+      size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+      if (diff == 0) {
+        if (m_tail.compare_exchange_weak(pos, pos + 1,
+                                         std::memory_order_relaxed)) {
+          slot.value = std::move(value);
+          slot.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = m_tail.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // false if the queue is empty
+  bool TryPop(T &value) {
+    size_t pos = m_head.load(std::memory_order_relaxed);
+    while (true) {
+      Slot &slot = m_slots[pos & m_mask];
+      size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+      if (diff == 0) {
+        if (m_head.compare_exchange_weak(pos, pos + 1,
+                                         std::memory_order_relaxed)) {
+          value = std::move(slot.value);
+          slot.sequence.store(pos + m_mask + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = m_head.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  size_t Capacity() const { return m_mask + 1; }
+
+private:
+  struct Slot {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  std::unique_ptr<Slot[]> m_slots;
+  size_t m_mask;
+  // producers and the consumer work on different cache lines
+  alignas(64) std::atomic<size_t> m_head;
+  alignas(64) std::atomic<size_t> m_tail;
+};
+
+} // namespace ClassGame
@@ -14,6 +14,8 @@ public:
 
     Entity() : _entityType(EntityNone), _parent(nullptr), _retainCount(0) {};
     Entity(EntityType type) : _entityType(type) {};
+    // virtual so release() destroys the whole object, not just the Entity part
+    virtual ~Entity() {};
 
     EntityType getEntityType() {return _entityType; }
     
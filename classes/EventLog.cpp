@@ -0,0 +1,121 @@
+#include "EventLog.h"
+#include "Logger.h"
+
+namespace ClassGame {
+
+EventLog &EventLog::GetInstance() {
+  static EventLog instance;
+  return instance;
+}
+
+EventLog::EventLog() : m_open(false), m_unflushedRecords(0), m_used(0) {}
+
+EventLog::~EventLog() { Close(); }
+
+bool EventLog::Open(const std::string &filename) {
+  Close();
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  // earlier runs are kept, this one adds a session after them
+  m_file.open(filename, std::ios::out | std::ios::binary | std::ios::app);
+  if (!m_file.is_open()) {
+    LOG_ERROR("Failed to open event log: {}", filename);
+    return false;
+  }
+
+  m_start = std::chrono::steady_clock::now();
+  m_lastFlush = m_start;
+  m_state = EventStreamState();
+  uint64_t wallClockNs =
+      (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count();
+  EncodeEventLogHeader(wallClockNs, m_buffer);
+  m_used = EVENT_LOG_HEADER_SIZE;
+  // a session with just its header is still a valid, empty one
+  FlushFile();
+  m_open = true;
+  return true;
+}
+
+void EventLog::Close() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_open) {
+    return;
+  }
+  m_open = false;
+  FlushFile();
+  m_file.close();
+}
+
+void EventLog::SetFlushPolicy(const EventFlushPolicy &policy) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_flushPolicy = policy;
+}
+
+void EventLog::Record(GameEventRecord record) {
+  if (!m_open) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_open) {
+    return;
+  }
+  auto now = std::chrono::steady_clock::now();
+  record.timeUs =
+      (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+          now - m_start)
+          .count();
+  if (m_used + EVENT_RECORD_MAX_SIZE > sizeof(m_buffer)) {
+    WriteBuffer();
+  }
+  m_used += EncodeEventRecord(record, m_state, m_buffer + m_used);
+  m_unflushedRecords.fetch_add(1, std::memory_order_relaxed);
+  if (IsFlushDue(now)) {
+    FlushFile();
+  }
+}
+
+void EventLog::Flush() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_open) {
+    FlushFile();
+  }
+}
+
+void EventLog::FlushIfDue() {
+  // nothing waiting is the common case, skip the lock
+  if (!m_open || m_unflushedRecords.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_open && IsFlushDue(std::chrono::steady_clock::now())) {
+    FlushFile();
+  }
+}
+
+bool EventLog::IsFlushDue(std::chrono::steady_clock::time_point now) const {
+  size_t unflushed = m_unflushedRecords.load(std::memory_order_relaxed);
+  return (m_flushPolicy.everyRecords > 0 &&
+          unflushed >= m_flushPolicy.everyRecords) ||
+         (m_flushPolicy.everyMs > 0 && unflushed > 0 &&
+          now - m_lastFlush >=
+              std::chrono::milliseconds(m_flushPolicy.everyMs));
+}
+
+void EventLog::WriteBuffer() {
+  if (m_used > 0) {
+    m_file.write((const char *)m_buffer, (std::streamsize)m_used);
+    m_used = 0;
+  }
+}
+
+void EventLog::FlushFile() {
+  WriteBuffer();
+  m_file.flush();
+  m_unflushedRecords.store(0, std::memory_order_relaxed);
+  m_lastFlush = std::chrono::steady_clock::now();
+}
+
+} // namespace ClassGame
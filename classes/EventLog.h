@@ -0,0 +1,71 @@
+#pragma once
+
+#include "EventLogFormat.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+namespace ClassGame {
+
+// When buffered records are written and flushed; whichever trigger comes
+// first. A zero count or interval turns that trigger off.
+struct EventFlushPolicy {
+  size_t everyRecords = 32;
+  int everyMs = 1000;
+};
+
+//
+// Writer for the event log file described in EventLogFormat.h
+//
+class EventLog {
+public:
+  // Singleton pattern, like Logger
+  static EventLog &GetInstance();
+
+  EventLog(const EventLog &) = delete;
+  EventLog &operator=(const EventLog &) = delete;
+
+  ~EventLog();
+
+  // Start a new session at the end of the file, creating it if needed
+  bool Open(const std::string &filename);
+  void Close();
+  bool IsOpen() const { return m_open; }
+
+  void SetFlushPolicy(const EventFlushPolicy &policy);
+
+  // Stamp and append a record. Records are buffered in memory and written
+  // out as the flush policy says, on Flush and on Close; a no-op when closed.
+  void Record(GameEventRecord record);
+  // Write and flush everything recorded so far, e.g. when a game ends
+  void Flush();
+  // Apply the time trigger of the flush policy; call regularly (once a frame)
+  // so records don't sit in memory while no new ones arrive
+  void FlushIfDue();
+
+private:
+  EventLog();
+
+  // callers hold m_mutex
+  void WriteBuffer();
+  void FlushFile();
+  bool IsFlushDue(std::chrono::steady_clock::time_point now) const;
+
+  std::mutex m_mutex;
+  std::ofstream m_file;
+  std::atomic<bool> m_open;
+  std::chrono::steady_clock::time_point m_start;
+  EventStreamState m_state;
+  EventFlushPolicy m_flushPolicy;
+  // records not flushed to the file yet, read without the lock by FlushIfDue
+  std::atomic<size_t> m_unflushedRecords;
+  std::chrono::steady_clock::time_point m_lastFlush;
+  uint8_t m_buffer[4096];
+  size_t m_used;
+};
+
+} // namespace ClassGame
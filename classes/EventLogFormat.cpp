@@ -0,0 +1,194 @@
+#include "EventLogFormat.h"
+#include <algorithm>
+
+namespace ClassGame {
+
+//
+// little-endian field helpers, the file layout doesn't depend on the host
+//
+static void putU16(uint8_t *out, uint16_t value) {
+  out[0] = (uint8_t)value;
+  out[1] = (uint8_t)(value >> 8);
+}
+
+static void putU64(uint8_t *out, uint64_t value) {
+  for (int i = 0; i < 8; i++) {
+    out[i] = (uint8_t)(value >> (8 * i));
+  }
+}
+
+static uint16_t getU16(const uint8_t *in) {
+  return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+static uint64_t getU64(const uint8_t *in) {
+  uint64_t value = 0;
+  for (int i = 0; i < 8; i++) {
+    value |= (uint64_t)in[i] << (8 * i);
+  }
+  return value;
+}
+
+// LEB128: seven bits per byte, low bits first, high bit set on all but the
+// last byte
+static size_t putVarint(uint8_t *out, uint64_t value) {
+  size_t used = 0;
+  while (value >= 0x80) {
+    out[used++] = (uint8_t)(value | 0x80);
+    value >>= 7;
+  }
+  out[used++] = (uint8_t)value;
+  return used;
+}
+
+// 0 if the varint runs past size or is longer than any u64
+static size_t getVarint(const uint8_t *in, size_t size, uint64_t &value) {
+  value = 0;
+  for (size_t used = 0; used < size && used < 10; used++) {
+    value |= (uint64_t)(in[used] & 0x7f) << (7 * used);
+    if ((in[used] & 0x80) == 0) {
+      return used + 1;
+    }
+  }
+  return 0;
+}
+
+static const uint8_t EVENT_BOARD_PRESENT = 0x10;
+
+void EncodeEventLogHeader(uint64_t wallClockNs,
+                          uint8_t out[EVENT_LOG_HEADER_SIZE]) {
+  out[0] = 'T';
+  out[1] = 'T';
+  out[2] = 'E';
+  out[3] = 'V';
+  putU16(out + 4, EVENT_LOG_VERSION);
+  putU16(out + 6, 0);
+  putU64(out + 8, wallClockNs);
+}
+
+bool IsEventLogHeader(const uint8_t *in, size_t size) {
+  return size >= 4 && in[0] == 'T' && in[1] == 'T' && in[2] == 'E' &&
+         in[3] == 'V';
+}
+
+bool DecodeEventLogHeader(const uint8_t in[EVENT_LOG_HEADER_SIZE],
+                          uint64_t &wallClockNs) {
+  if (!IsEventLogHeader(in, EVENT_LOG_HEADER_SIZE)) {
+    return false;
+  }
+  if (getU16(in + 4) != EVENT_LOG_VERSION) {
+    return false;
+  }
+  wallClockNs = getU64(in + 8);
+  return true;
+}
+
+// the board a move record leaves out: the previous one plus the move
+static bool isImpliedBoard(const GameEventRecord &record,
+                           const EventStreamState &state) {
+  if (record.move < 0 || record.move >= 9 || record.player < 0 ||
+      record.player > 1) {
+    return false;
+  }
+  uint32_t piece = 1u << (record.move + 9 * record.player);
+  return record.board == (state.board | piece);
+}
+
+size_t EncodeEventRecord(const GameEventRecord &record, EventStreamState &state,
+                         uint8_t out[EVENT_RECORD_MAX_SIZE]) {
+  // the clock never runs backwards, but a hand-made record might
+  uint64_t timeUs = std::max(record.timeUs, state.timeUs);
+  bool hasBoard = !isImpliedBoard(record, state);
+
+  size_t used = putVarint(out, timeUs - state.timeUs);
+  out[used++] = (uint8_t)(((uint8_t)record.id & 0x0f) |
+                          (hasBoard ? EVENT_BOARD_PRESENT : 0) |
+                          ((uint8_t)record.level << 5));
+  out[used++] = (uint8_t)((record.player + 1) | ((record.move + 1) << 2));
+  if (hasBoard) {
+    used += putVarint(out + used, record.board);
+  }
+  if (record.id == GameEventId::AI_MOVE) {
+    used += putVarint(out + used, record.aiNodes);
+    used += putVarint(out + used, record.aiMicros);
+  }
+
+  state.timeUs = timeUs;
+  state.board = record.board;
+  return used;
+}
+
+size_t DecodeEventRecord(const uint8_t *in, size_t size,
+                         EventStreamState &state, GameEventRecord &record) {
+  uint64_t value = 0;
+  size_t used = getVarint(in, size, value);
+  if (used == 0 || size - used < 2) {
+    return 0;
+  }
+  record = GameEventRecord();
+  record.timeUs = state.timeUs + value;
+  uint8_t tag = in[used++];
+  uint8_t squares = in[used++];
+  // no player 2 and no square past 8, which also keeps a session header
+  // from ever reading as a record
+  if ((squares & 0x03) > 2 || (squares >> 2) > 9) {
+    return 0;
+  }
+  record.id = (GameEventId)(tag & 0x0f);
+  record.level = (LogLevel)(tag >> 5);
+  record.player = (int8_t)((squares & 0x03) - 1);
+  record.move = (int8_t)((squares >> 2) - 1);
+
+  if (tag & EVENT_BOARD_PRESENT) {
+    size_t got = getVarint(in + used, size - used, value);
+    if (got == 0) {
+      return 0;
+    }
+    used += got;
+    record.board = (uint32_t)value;
+  } else {
+    record.board = state.board;
+    if (record.move >= 0 && record.move < 9 && record.player >= 0) {
+      record.board |= 1u << (record.move + 9 * record.player);
+    }
+  }
+
+  if (record.id == GameEventId::AI_MOVE) {
+    size_t got = getVarint(in + used, size - used, value);
+    if (got == 0) {
+      return 0;
+    }
+    used += got;
+    record.aiNodes = (uint32_t)value;
+    got = getVarint(in + used, size - used, value);
+    if (got == 0) {
+      return 0;
+    }
+    used += got;
+    record.aiMicros = (uint32_t)value;
+  }
+
+  state.timeUs = record.timeUs;
+  state.board = record.board;
+  return used;
+}
+
+const char *GetGameEventName(GameEventId id) {
+  switch (id) {
+  case GameEventId::GAME_STARTED:
+    return "GAME_STARTED";
+  case GameEventId::GAME_RESET:
+    return "GAME_RESET";
+  case GameEventId::HUMAN_MOVE:
+    return "HUMAN_MOVE";
+  case GameEventId::AI_MOVE:
+    return "AI_MOVE";
+  case GameEventId::GAME_WON:
+    return "GAME_WON";
+  case GameEventId::GAME_DRAWN:
+    return "GAME_DRAWN";
+  }
+  return "UNKNOWN";
+}
+
+} // namespace ClassGame
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "LogLevel.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace ClassGame {
+
+//
+// Binary structured game event log, file format
+//
+// A compact companion to the text application.log for LogLevel::GAME_EVENT
+// style records. Each run of the game appends a session to the file: a header
+// followed by variable-length records, each stored relative to the one
+// before it, so a session has to be read from its header on;
+// tools/eventlog_decode.cpp turns the file back into text or CSV.
+//
+//   header (16 bytes): "TTEV", u16 version, u16 reserved,
+//                      u64 system clock at open (ns since the epoch)
+//   record:            varint us since the previous record (steady clock),
+//                      u8 event id | board present << 4 | level << 5,
+//                      u8 (player + 1) | (move + 1) << 2,
+//                      varint board, only if present,
+//                      varint AI nodes, varint AI time (us), AI_MOVE only
+//
+// Integers are LEB128 varints. A move record leaves the board out when it is
+// the previous board plus the move, which it nearly always is, so a typical
+// move takes 5 bytes.
+//
+
+enum class GameEventId : uint16_t {
+  GAME_STARTED = 1,
+  GAME_RESET,
+  HUMAN_MOVE,
+  AI_MOVE,
+  GAME_WON,
+  GAME_DRAWN
+};
+
+struct GameEventRecord {
+  uint64_t timeUs = 0; // filled in by EventLog::Record
+  GameEventId id = GameEventId::GAME_STARTED;
+  LogLevel level = LogLevel::GAME_EVENT;
+  int8_t player = -1; // player number, -1 if none
+  int8_t move = -1;   // square 0-8, -1 if none
+  uint32_t board = 0; // TicTacToeBoard::key(): X mask | O mask << 9
+  uint32_t aiNodes = 0;
+  uint32_t aiMicros = 0;
+};
+
+const uint16_t EVENT_LOG_VERSION = 2;
+const size_t EVENT_LOG_HEADER_SIZE = 16;
+// largest encoded record: 10 + 1 + 1 + 3 + 5 + 5 bytes
+const size_t EVENT_RECORD_MAX_SIZE = 25;
+
+// What the previous record left behind, kept by both the writer and the
+// reader since records only hold the difference
+struct EventStreamState {
+  uint64_t timeUs = 0;
+  uint32_t board = 0;
+};
+
+void EncodeEventLogHeader(uint64_t wallClockNs,
+                          uint8_t out[EVENT_LOG_HEADER_SIZE]);
+// true if a session header starts here, whatever its version
+bool IsEventLogHeader(const uint8_t *in, size_t size);
+// false if the bytes are not an event log header this version can read
+bool DecodeEventLogHeader(const uint8_t in[EVENT_LOG_HEADER_SIZE],
+                          uint64_t &wallClockNs);
+// Returns the number of bytes written to out and advances state
+size_t EncodeEventRecord(const GameEventRecord &record, EventStreamState &state,
+                         uint8_t out[EVENT_RECORD_MAX_SIZE]);
+// Returns the number of bytes read and advances state, 0 if the record is
+// cut short or malformed (a session header is always malformed as a record)
+size_t DecodeEventRecord(const uint8_t *in, size_t size,
+                         EventStreamState &state, GameEventRecord &record);
+const char *GetGameEventName(GameEventId id);
+
+} // namespace ClassGame
@@ -2,6 +2,8 @@
 #include "Bit.h"
 #include "BitHolder.h"
 #include "Turn.h"
+#include "Metrics.h"
+#include "Trace.h"
 #include "../Application.h"
 
 Game::Game()
@@ -15,6 +17,7 @@ Game::Game()
 	_gameOptions.rowY = 0;
 	_gameOptions.score = 0;
 	_gameOptions.AIDepthSearches = 0;
+	_gameOptions.AIMAXDepth = 0;
 	_gameOptions.AIvsAI = false;
 	
 	_score = 0;
@@ -22,6 +25,7 @@ Game::Game()
 	_winner = nullptr;
 	_lastMove = "";
 	_gameNumber = -1;
+	_dirty = true;
 }
 
 
@@ -76,10 +80,19 @@ void Game::startGame()
 	turn->_boardState = startState;
 	turn->_gameNumber = _gameNumber;
 	_gameOptions.currentTurnNo = 0;
+	setDirty();
 }
 
 void Game::endTurn()
 {
+	static ClassGame::Counter &turns = ClassGame::Metrics::GetInstance().GetCounter(
+		"game_turns_total", "Turns played");
+	static ClassGame::LatencyHistogram &endTurnTime = ClassGame::Metrics::GetInstance().GetHistogram(
+		"game_end_turn_seconds", "Time spent in Game::endTurn, including the winner check");
+	ClassGame::ScopedLatency timer(endTurnTime);
+	turns.Add();
+	setDirty();
+
 	_gameOptions.currentTurnNo++;
 	std::string startState = stateString();
 	Turn *turn = new Turn;
@@ -93,6 +106,8 @@ void Game::endTurn()
 
 void Game::scanForMouse()
 {
+    TRACE_SCOPE("Game::scanForMouse");
+
     //if (gameHasAI() && getCurrentPlayer()->isAIPlayer()) 
     //{
     //    updateAI();
@@ -127,17 +142,21 @@ void Game::scanForMouse()
 //
 void Game::drawFrame()
 {
+    TRACE_SCOPE("Game::drawFrame");
     scanForMouse();
 
+    // squares and pieces go straight into the window's draw list as textured quads, pieces
+    // on the layer above the squares, rather than as one ImGui item per sprite
     for (int y=0; y<_gameOptions.rowY; y++) {
         for (int x=0; x<_gameOptions.rowX; x++) {
 			BitHolder &holder = getHolderAt(x, y);
-            holder.paintSprite();
+            holder.batchSprite(_spriteBatch, 0);
             if (holder.bit()) {
-                holder.bit()->paintSprite();
+                holder.bit()->batchSprite(_spriteBatch, 1);
             }
         }
     }
+    _spriteBatch.draw();
 }
 
 void Game::bitMovedFromTo(Bit *bit, BitHolder *src, BitHolder *dst)
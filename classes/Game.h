@@ -8,24 +8,11 @@
 #include "Turn.h"
 #include "Bit.h"
 #include "BitHolder.h"
+#include "GameOptions.h"
+#include "SpriteBatch.h"
 
 class GameTable;
 
-struct GameOptions
-{
-	bool AIPlaying;
-	int numberOfPlayers;
-	int AIPlayer;
-	int rowX;
-	int rowY;
-	int gameNumber;
-	unsigned int currentTurnNo;
-	int score;
-	int AIDepthSearches;
-	int AIMAXDepth;
-	bool AIvsAI;
-};
-
 class Game
 {
 public:
@@ -41,6 +28,10 @@ public:
 
 	// end the current game turn
 	void	endTurn();
+
+	// the board changed since the last takeDirty(), the render loop can't sleep yet
+	void	setDirty() { _dirty = true; }
+	bool	takeDirty() { bool dirty = _dirty; _dirty = false; return dirty; }
 	
 	// Should return true if it is legal for the given bit to be moved from its current holder.
 	// Default implementation always returns true. 
@@ -104,5 +95,10 @@ public:
 	GameOptions 			_gameOptions;
 
 	int						_gameNumber;
+
+private:
+	// squares and pieces for drawFrame, reused every frame
+	SpriteBatch				_spriteBatch;
+	bool					_dirty;
 };
 
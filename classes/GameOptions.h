@@ -0,0 +1,20 @@
+#pragma once
+
+//
+// per-game settings, kept free of any engine types so headless tools can
+// use them too
+//
+struct GameOptions
+{
+	bool AIPlaying;
+	int numberOfPlayers;
+	int AIPlayer;
+	int rowX;
+	int rowY;
+	int gameNumber;
+	unsigned int currentTurnNo;
+	int score;
+	int AIDepthSearches;	// searches the AI has run
+	int AIMAXDepth;			// plies the AI looks ahead, 0 for no limit
+	bool AIvsAI;			// both sides are played by the AI
+};
@@ -0,0 +1,113 @@
+#include "LogConsoleView.h"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+
+namespace ClassGame {
+
+LogConsoleView::LogConsoleView()
+    : m_dropped(0), m_nextSequence(0), m_useRegex(false), m_regexValid(true) {
+  for (int i = 0; i < LOG_LEVEL_COUNT; i++) {
+    m_levelEnabled[i] = true;
+  }
+}
+
+void LogConsoleView::Update(const Logger &logger) {
+  m_incoming.clear();
+  m_nextSequence = logger.ReadLogEntriesSince(m_nextSequence, m_incoming);
+
+  for (LogEntryPtr &entry : m_incoming) {
+    uint64_t position = m_dropped + m_entries.size();
+    int level = (int)entry->level;
+    m_byLevel[level].push_back(position);
+    if (m_levelEnabled[level] && MatchesText(*entry)) {
+      m_matches.push_back(position);
+    }
+    m_entries.push_back(std::move(entry));
+  }
+
+  // drop what the logger has evicted or cleared, oldest first
+  uint64_t firstSequence = logger.GetFirstLogSequence();
+  while (!m_entries.empty() && m_entries.front()->sequence < firstSequence) {
+    m_entries.pop_front();
+    m_dropped++;
+  }
+  for (std::deque<uint64_t> &positions : m_byLevel) {
+    while (!positions.empty() && positions.front() < m_dropped) {
+      positions.pop_front();
+    }
+  }
+  while (!m_matches.empty() && m_matches.front() < m_dropped) {
+    m_matches.pop_front();
+  }
+}
+
+void LogConsoleView::SetLevelEnabled(LogLevel level, bool enabled) {
+  if (m_levelEnabled[(int)level] == enabled) {
+    return;
+  }
+  m_levelEnabled[(int)level] = enabled;
+  RebuildMatches();
+}
+
+bool LogConsoleView::SetTextFilter(const std::string &text, bool useRegex) {
+  m_useRegex = useRegex;
+  m_regexValid = true;
+  if (useRegex) {
+    m_text = text;
+    try {
+      m_regex.assign(text, std::regex::ECMAScript | std::regex::icase |
+                               std::regex::optimize);
+    } catch (const std::regex_error &) {
+      m_regexValid = false;
+    }
+  } else {
+    m_text.resize(text.size());
+    std::transform(text.begin(), text.end(), m_text.begin(),
+                   [](unsigned char c) { return (char)std::tolower(c); });
+  }
+  RebuildMatches();
+  return m_regexValid;
+}
+
+bool LogConsoleView::MatchesText(const LogEntry &entry) const {
+  if (m_text.empty()) {
+    return true;
+  }
+  if (m_useRegex) {
+    return m_regexValid && std::regex_search(entry.message, m_regex);
+  }
+  auto found = std::search(
+      entry.message.begin(), entry.message.end(), m_text.begin(),
+      m_text.end(), [](char a, char b) {
+        return std::tolower((unsigned char)a) == (unsigned char)b;
+      });
+  return found != entry.message.end();
+}
+
+//
+// merge the per-level indices of the enabled levels (each already in order)
+// and apply the text filter to just those entries
+//
+void LogConsoleView::RebuildMatches() {
+  std::vector<uint64_t> merged;
+  std::vector<uint64_t> scratch;
+  for (int level = 0; level < LOG_LEVEL_COUNT; level++) {
+    if (!m_levelEnabled[level]) {
+      continue;
+    }
+    scratch.clear();
+    std::merge(merged.begin(), merged.end(), m_byLevel[level].begin(),
+               m_byLevel[level].end(), std::back_inserter(scratch));
+    merged.swap(scratch);
+  }
+
+  m_matches.clear();
+  for (uint64_t position : merged) {
+    if (MatchesText(*m_entries[position - m_dropped])) {
+      m_matches.push_back(position);
+    }
+  }
+}
+
+} // namespace ClassGame
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Logger.h"
+#include <cstdint>
+#include <deque>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace ClassGame {
+
+//
+// What the Log Console shows: the logger's history filtered by level and by
+// a substring or regex, kept up to date incrementally
+//
+// Update() only looks at entries logged since the last call. Each entry is
+// filed in a per-level index and, if it passes the current filter, appended
+// to the match list, so a frame with no new entries does no work at all.
+// Changing the level toggles rebuilds the match list by merging the
+// per-level indices; only a new text filter rescans the messages, and then
+// only those of the enabled levels.
+//
+class LogConsoleView {
+public:
+  LogConsoleView();
+
+  // pull new entries from the logger and forget those it has dropped
+  void Update(const Logger &logger);
+
+  void SetLevelEnabled(LogLevel level, bool enabled);
+  bool IsLevelEnabled(LogLevel level) const {
+    return m_levelEnabled[(int)level];
+  }
+  // case-insensitive substring, or ECMAScript regex if useRegex; an empty
+  // text matches everything. false if the regex doesn't compile, nothing
+  // matches until it is fixed
+  bool SetTextFilter(const std::string &text, bool useRegex);
+
+  // entries that pass the filter, oldest first
+  size_t GetMatchCount() const { return m_matches.size(); }
+  const LogEntry &GetMatch(size_t index) const {
+    return *m_entries[m_matches[index] - m_dropped];
+  }
+  size_t GetEntryCount() const { return m_entries.size(); }
+
+private:
+  bool MatchesText(const LogEntry &entry) const;
+  void RebuildMatches();
+
+  // entries are addressed by position: number of entries ever taken in, so
+  // positions stay valid as old entries are dropped from the front
+  std::deque<LogEntryPtr> m_entries;
+  uint64_t m_dropped;
+  uint64_t m_nextSequence;
+  std::vector<LogEntryPtr> m_incoming;
+
+  std::deque<uint64_t> m_byLevel[LOG_LEVEL_COUNT];
+  std::deque<uint64_t> m_matches;
+
+  bool m_levelEnabled[LOG_LEVEL_COUNT];
+  std::string m_text; // lower case for substring matching
+  bool m_useRegex;
+  bool m_regexValid;
+  std::regex m_regex;
+};
+
+} // namespace ClassGame
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <version>
+
+#if defined(__cpp_lib_format)
+#include <format>
+#endif
+
+namespace ClassGame {
+
+//
+// "{}" style message formatting for the LOG_* macros in Logger.h
+//
+// Uses std::format (with compile-time checked format strings) where the
+// standard library has it. Otherwise a small fallback replaces each "{}" with
+// the next argument and "{{" / "}}" with literal braces; format specs such as
+// "{:x}" are not supported there and floats print like std::to_string.
+//
+
+#if defined(__cpp_lib_format)
+
+template <typename... Args>
+using LogFormatString = std::format_string<Args...>;
+
+template <typename... Args>
+std::string FormatLogMessage(LogFormatString<Args...> format, Args &&...args) {
+  return std::format(format, std::forward<Args>(args)...);
+}
+
+#else
+
+template <typename... Args> using LogFormatString = std::string_view;
+
+namespace LogFormatDetail {
+
+// Copy literal text from format[pos] up to the next "{}", which is consumed.
+// Returns false once the end of the format string is reached instead.
+inline bool AppendLiteral(std::string &out, std::string_view format,
+                          size_t &pos) {
+  while (pos < format.size()) {
+    char c = format[pos];
+    char next = pos + 1 < format.size() ? format[pos + 1] : '\0';
+    if (c == '{' && next == '}') {
+      pos += 2;
+      return true;
+    }
+    if ((c == '{' && next == '{') || (c == '}' && next == '}')) {
+      pos++;
+    }
+    out += c;
+    pos++;
+  }
+  return false;
+}
+
+inline void AppendArg(std::string &out, std::string_view value) {
+  out += value;
+}
+inline void AppendArg(std::string &out, const std::string &value) {
+  out += value;
+}
+inline void AppendArg(std::string &out, const char *value) {
+  out += value ? value : "(null)";
+}
+inline void AppendArg(std::string &out, char value) { out += value; }
+inline void AppendArg(std::string &out, bool value) {
+  out += value ? "true" : "false";
+}
+template <typename T>
+  requires std::is_arithmetic_v<T>
+void AppendArg(std::string &out, T value) {
+  out += std::to_string(value);
+}
+
+} // namespace LogFormatDetail
+
+template <typename... Args>
+std::string FormatLogMessage(LogFormatString<Args...> format,
+                             Args &&...args) {
+  std::string out;
+  out.reserve(format.size() + 8 * sizeof...(Args));
+  size_t pos = 0;
+  (
+      [&] {
+        if (LogFormatDetail::AppendLiteral(out, format, pos)) {
+          LogFormatDetail::AppendArg(out, args);
+        }
+      }(),
+      ...);
+  // placeholders without an argument are kept as they are
+  while (LogFormatDetail::AppendLiteral(out, format, pos)) {
+    out += "{}";
+  }
+  return out;
+}
+
+#endif
+
+} // namespace ClassGame
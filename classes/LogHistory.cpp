@@ -0,0 +1,121 @@
+#include "LogHistory.h"
+#include "Logger.h"
+#include <algorithm>
+#include <thread>
+
+namespace ClassGame {
+
+LogHistory::LogHistory(size_t capacity)
+    : m_next(0), m_appending(0), m_replacingRing(false) {
+  m_ring.Store(std::make_shared<const Ring>(std::max<size_t>(capacity, 1), 0));
+}
+
+void LogHistory::Append(LogEntry &&entry) {
+  // announce the append before checking for a ring swap, the swap announces
+  // itself before checking for appends, so one of the two always sees the
+  // other (both sequentially consistent)
+  while (true) {
+    m_appending.fetch_add(1);
+    if (!m_replacingRing.load()) {
+      break;
+    }
+    m_appending.fetch_sub(1);
+    while (m_replacingRing.load(std::memory_order_relaxed)) {
+      std::this_thread::yield();
+    }
+  }
+
+  uint64_t sequence = m_next.fetch_add(1, std::memory_order_relaxed);
+  entry.sequence = sequence;
+  auto stored = std::make_shared<const LogEntry>(std::move(entry));
+  std::shared_ptr<const Ring> ring = m_ring.Load();
+  AtomicSharedPtr<const LogEntry> &slot = ring->slots[sequence % ring->size];
+  // an append that fell a whole ring behind must not overwrite the newer
+  // entry that has taken its slot meanwhile
+  LogEntryPtr current = slot.Load();
+  while (!current || current->sequence < sequence) {
+    if (slot.CompareExchange(current, stored)) {
+      break;
+    }
+  }
+
+  m_appending.fetch_sub(1, std::memory_order_release);
+}
+
+void LogHistory::BeginReplaceRing() {
+  m_replacingRing.store(true);
+  while (m_appending.load() != 0) {
+    std::this_thread::yield();
+  }
+}
+
+void LogHistory::EndReplaceRing() {
+  m_replacingRing.store(false, std::memory_order_release);
+}
+
+void LogHistory::Clear() {
+  BeginReplaceRing();
+  // drop the entries themselves, readers still holding the old ring or
+  // entries keep them alive until they are done
+  m_ring.Store(std::make_shared<const Ring>(
+      Capacity(), m_next.load(std::memory_order_relaxed)));
+  EndReplaceRing();
+}
+
+void LogHistory::SetCapacity(size_t capacity) {
+  capacity = std::max<size_t>(capacity, 1);
+  std::shared_ptr<const Ring> ring = m_ring.Load();
+  if (capacity == ring->size) {
+    return;
+  }
+
+  // every slot up to m_next is filled once the appends in progress are done
+  BeginReplaceRing();
+
+  uint64_t next = m_next.load(std::memory_order_relaxed);
+  uint64_t first = std::max(FirstSequence(*ring, next),
+                            next - std::min<uint64_t>(next, capacity));
+  auto resized = std::make_shared<Ring>(capacity, first);
+  for (uint64_t sequence = first; sequence < next; sequence++) {
+    resized->slots[sequence % capacity].Store(
+        ring->slots[sequence % ring->size].Load());
+  }
+  m_ring.Store(std::move(resized));
+  EndReplaceRing();
+}
+
+size_t LogHistory::Capacity() const { return m_ring.Load()->size; }
+
+uint64_t LogHistory::FirstSequence(const Ring &ring, uint64_t next) const {
+  uint64_t first = next - std::min<uint64_t>(next, ring.size);
+  return std::max(first, ring.first);
+}
+
+uint64_t LogHistory::GetFirstSequence() const {
+  uint64_t next = GetNextSequence();
+  return FirstSequence(*m_ring.Load(), next);
+}
+
+uint64_t LogHistory::ReadSince(uint64_t since,
+                               std::vector<LogEntryPtr> &out) const {
+  // next before the ring: a ring loaded afterwards is at least as new, so it
+  // holds every entry before next that hasn't been evicted or cleared
+  uint64_t next = GetNextSequence();
+  std::shared_ptr<const Ring> ring = m_ring.Load();
+  for (uint64_t sequence = std::max(since, FirstSequence(*ring, next));
+       sequence < next; sequence++) {
+    LogEntryPtr entry = ring->slots[sequence % ring->size].Load();
+    // an older entry (or none) means this one is still being appended, the
+    // caller gets it next time
+    if (!entry || entry->sequence < sequence) {
+      return sequence;
+    }
+    // a newer entry in the slot means this one was evicted meanwhile
+    if (entry->sequence == sequence) {
+      out.push_back(std::move(entry));
+    }
+  }
+  return std::max(since, next);
+}
+
+} // namespace ClassGame
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ClassGame {
+
+struct LogEntry;
+
+// Entries are immutable once they are in the history, readers share them
+using LogEntryPtr = std::shared_ptr<const LogEntry>;
+
+//
+// shared_ptr that can be loaded and replaced from several threads; uses
+// std::atomic<std::shared_ptr> where the library has it
+//
+template <typename T> class AtomicSharedPtr {
+public:
+#if defined(__cpp_lib_atomic_shared_ptr)
+  std::shared_ptr<T> Load() const {
+    return m_ptr.load(std::memory_order_acquire);
+  }
+  void Store(std::shared_ptr<T> ptr) {
+    m_ptr.store(std::move(ptr), std::memory_order_release);
+  }
+  // On failure expected is updated to the current value
+  bool CompareExchange(std::shared_ptr<T> &expected,
+                       std::shared_ptr<T> desired) {
+    return m_ptr.compare_exchange_strong(expected, std::move(desired),
+                                         std::memory_order_acq_rel,
+                                         std::memory_order_acquire);
+  }
+
+private:
+  std::atomic<std::shared_ptr<T>> m_ptr;
+#else
+  std::shared_ptr<T> Load() const {
+    return std::atomic_load_explicit(&m_ptr, std::memory_order_acquire);
+  }
+  void Store(std::shared_ptr<T> ptr) {
+    std::atomic_store_explicit(&m_ptr, std::move(ptr),
+                               std::memory_order_release);
+  }
+  bool CompareExchange(std::shared_ptr<T> &expected,
+                       std::shared_ptr<T> desired) {
+    return std::atomic_compare_exchange_strong_explicit(
+        &m_ptr, &expected, std::move(desired), std::memory_order_acq_rel,
+        std::memory_order_acquire);
+  }
+
+private:
+  std::shared_ptr<T> m_ptr;
+#endif
+};
+
+//
+// In-memory log history readers can walk without taking a lock
+//
+// Every entry gets a sequence number as it is appended; a fixed number of the
+// newest entries are kept in a ring of slots, each an atomically replaced
+// pointer to an immutable entry. Readers ask for "everything since sequence
+// N" and get back shared pointers, so a reader always sees whole entries and
+// never holds up the thread that is logging. An entry that is overwritten
+// while being read is simply skipped, it has left the history anyway.
+//
+// Any number of threads may append at once: each takes the next sequence
+// number with one atomic increment and stores into its own slot. A reader
+// that reaches a sequence whose entry is not stored yet stops there and picks
+// it up on its next read. Only Clear and SetCapacity, which replace the ring,
+// wait for the appends in progress to finish.
+//
+class LogHistory {
+public:
+  explicit LogHistory(size_t capacity);
+
+  // Writer side, any thread, never takes a lock
+  void Append(LogEntry &&entry);
+  // These replace the ring, one thread at a time (the Logger serializes
+  // them); appends wait while they run
+  void Clear();
+  // Resize, keeping the newest entries that still fit
+  void SetCapacity(size_t capacity);
+
+  // Reader side, any thread, never blocks
+  size_t Capacity() const;
+  // Sequence number the next entry will get; entries just before it may still
+  // be on their way into the ring
+  uint64_t GetNextSequence() const {
+    return m_next.load(std::memory_order_acquire);
+  }
+  // Oldest sequence number still held (== GetNextSequence() when empty)
+  uint64_t GetFirstSequence() const;
+  // Append the entries with sequence >= since to out, oldest first, and
+  // return the sequence to pass next time to only get newer entries
+  uint64_t ReadSince(uint64_t since, std::vector<LogEntryPtr> &out) const;
+
+private:
+  struct Ring {
+    Ring(size_t size, uint64_t first)
+        : size(size), first(first),
+          slots(new AtomicSharedPtr<const LogEntry>[size]) {}
+    size_t size;
+    // entries before this were cleared or didn't fit when the ring replaced
+    // the previous one
+    uint64_t first;
+    std::unique_ptr<AtomicSharedPtr<const LogEntry>[]> slots;
+  };
+
+  uint64_t FirstSequence(const Ring &ring, uint64_t next) const;
+  // Clear and SetCapacity hold appends off while they swap the ring
+  void BeginReplaceRing();
+  void EndReplaceRing();
+
+  AtomicSharedPtr<const Ring> m_ring;
+  std::atomic<uint64_t> m_next;
+  // Append calls in progress, and whether the ring is being replaced
+  std::atomic<int> m_appending;
+  std::atomic<bool> m_replacingRing;
+};
+
+} // namespace ClassGame
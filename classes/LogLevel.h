@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string_view>
+
+namespace ClassGame {
+
+//
+// Log levels on their own, for code that tags records with a level (the
+// event log and its decoder) without pulling in the Logger
+//
+enum class LogLevel { INFO, WARNING, ERROR, DEBUG, GAME_EVENT };
+const int LOG_LEVEL_COUNT = 5;
+
+// Ordering used for level filtering, LogLevel's own values are not ordered
+constexpr int LogLevelSeverity(LogLevel level) {
+  switch (level) {
+  case LogLevel::DEBUG:
+    return 0;
+  case LogLevel::INFO:
+    return 1;
+  case LogLevel::GAME_EVENT:
+    return 2;
+  case LogLevel::WARNING:
+    return 3;
+  case LogLevel::ERROR:
+    return 4;
+  }
+  return 4;
+}
+
+// Name shown in brackets at the start of a log line
+constexpr std::string_view LogLevelName(LogLevel level) {
+  switch (level) {
+  case LogLevel::INFO:
+    return "INFO";
+  case LogLevel::WARNING:
+    return "WARN";
+  case LogLevel::ERROR:
+    return "ERROR";
+  case LogLevel::DEBUG:
+    return "DEBUG";
+  case LogLevel::GAME_EVENT:
+    return "GAME";
+  default:
+    return "UNKNOWN";
+  }
+}
+
+} // namespace ClassGame
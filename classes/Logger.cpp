@@ -1,24 +1,46 @@
 #include "Logger.h"
 #include <algorithm>
 #include <chrono>
-#include <iomanip>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
 #include <iostream>
-#include <sstream>
 
 namespace ClassGame {
 
+LogEntry::LogEntry(LogLevel l, const std::string &msg, LogClock::time_point t)
+    : level(l), message(msg), time(t), timestamp(Logger::FormatTimestamp(t)) {
+  std::string_view name = Logger::GetLogLevelName(l);
+  displayLine.reserve(name.size() + timestamp.size() + msg.size() + 5);
+  displayLine += '[';
+  displayLine += name;
+  displayLine += "] ";
+  displayLine += timestamp;
+  displayLine += ": ";
+  displayLine += msg;
+}
+
 Logger &Logger::GetInstance() {
   static Logger instance;
   return instance;
 }
 
-Logger::Logger() : m_fileLoggingEnabled(false) {
+Logger::Logger()
+    : m_logEntries(MAX_LOG_ENTRIES), m_fileLoggingEnabled(false),
+      m_queue(ASYNC_QUEUE_CAPACITY), m_asyncMode(false), m_stopWriter(false),
+      m_overflowPolicy(LogOverflowPolicy::DROP_AND_COUNT), m_droppedCount(0),
+      m_enqueuedCount(0), m_writtenCount(0) {
   // Initialize with default log file
   SetLogFile("application.log");
 }
 
 Logger::~Logger() {
+  // Anything still queued is written before the file is closed
+  StopWriter();
+
+  std::lock_guard<std::mutex> lock(m_fileMutex);
   if (m_logFile.is_open()) {
+    m_logFile.flush();
     m_logFile.close();
   }
 }
@@ -44,7 +66,7 @@ void Logger::LogGameEvent(const std::string &message) {
 }
 
 void Logger::SetLogFile(const std::string &filename) {
-  std::lock_guard<std::mutex> lock(m_logMutex);
+  std::lock_guard<std::mutex> lock(m_fileMutex);
 
   if (m_logFile.is_open()) {
     m_logFile.close();
@@ -58,33 +80,95 @@ void Logger::SetLogFile(const std::string &filename) {
     m_fileLoggingEnabled = false;
   } else {
     m_fileLoggingEnabled = true;
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(filename, error);
+    m_fileBytes = error ? 0 : (uint64_t)size;
+    m_unflushedEntries = 0;
+    m_lastFileFlush = std::chrono::steady_clock::now();
+
     // Write header to log file
-    m_logFile << "\n=== Log Session Started: " << GetCurrentTimestamp()
-              << " ===\n";
+    std::string header =
+        "\n=== Log Session Started: " + GetCurrentTimestamp() + " ===\n";
+    m_logFile << header;
     m_logFile.flush();
+    m_fileBytes += header.size();
   }
 }
 
 void Logger::EnableFileLogging(bool enable) {
-  std::lock_guard<std::mutex> lock(m_logMutex);
+  std::lock_guard<std::mutex> lock(m_fileMutex);
   m_fileLoggingEnabled = enable && m_logFile.is_open();
 }
 
+void Logger::SetRotationPolicy(const LogRotationPolicy &policy) {
+  std::lock_guard<std::mutex> lock(m_fileMutex);
+  m_rotationPolicy = policy;
+}
+
+void Logger::SetFlushPolicy(const LogFlushPolicy &policy) {
+  std::lock_guard<std::mutex> lock(m_fileMutex);
+  m_flushPolicy = policy;
+}
+
+void Logger::SetAsyncMode(bool enable) {
+  if (!enable) {
+    StopWriter();
+    return;
+  }
+  if (m_writerThread.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_writerMutex);
+    m_stopWriter = false;
+    m_writerPending = false;
+    m_asyncMode = true;
+  }
+  m_writerThread = std::thread(&Logger::WriterThread, this);
+}
+
+void Logger::SetOverflowPolicy(LogOverflowPolicy policy) {
+  m_overflowPolicy = policy;
+}
+
+void Logger::Flush() {
+  if (m_asyncMode) {
+    uint64_t target = m_enqueuedCount;
+    std::unique_lock<std::mutex> lock(m_writerMutex);
+    m_writerDone.wait(lock, [this, target] {
+      return m_writtenCount >= target || !m_asyncMode;
+    });
+  }
+
+  std::lock_guard<std::mutex> lock(m_fileMutex);
+  if (m_logFile.is_open()) {
+    FlushFileIfDue(true);
+  }
+}
+
 void Logger::AddLogEntry(LogLevel level, const std::string &message) {
-  std::lock_guard<std::mutex> lock(m_logMutex);
+  if (!IsEnabled(level)) {
+    return;
+  }
 
-  std::string timestamp = GetCurrentTimestamp();
-  LogEntry entry(level, message, timestamp);
+  LogEntry entry(level, message, LogClock::now());
 
-  // Add to memory for ImGui display
-  m_logEntries.push_back(entry);
+  // Add to memory for ImGui display, replacing the oldest entry once full
+  m_logEntries.Append(LogEntry(entry));
+  m_dirty.store(true, std::memory_order_relaxed);
 
-  // Limit memory usage
-  if (m_logEntries.size() > MAX_LOG_ENTRIES) {
-    m_logEntries.erase(m_logEntries.begin(),
-                       m_logEntries.begin() +
-                           (m_logEntries.size() - MAX_LOG_ENTRIES));
+  // Hand file and console output to the writer thread. StopWriter waits for
+  // every producer counted here, so an entry queued just as async mode is
+  // switched off still gets written.
+  m_asyncProducers.fetch_add(1);
+  if (m_asyncMode) {
+    EnqueueEntry(std::move(entry));
+    m_asyncProducers.fetch_sub(1, std::memory_order_release);
+    return;
   }
+  m_asyncProducers.fetch_sub(1, std::memory_order_release);
+
+  std::lock_guard<std::mutex> lock(m_fileMutex);
 
   // Write to file if enabled
   if (m_fileLoggingEnabled) {
@@ -92,57 +176,316 @@ void Logger::AddLogEntry(LogLevel level, const std::string &message) {
   }
 
   // Also output to console for debugging
-  std::cout << "[" << GetLogLevelString(level) << "] " << timestamp << ": "
-            << message << std::endl;
+  std::cout << entry.displayLine << std::endl;
 }
 
 void Logger::WriteToFile(const LogEntry &entry) {
   if (!m_logFile.is_open())
     return;
 
-  m_logFile << "[" << GetLogLevelString(entry.level) << "] " << entry.timestamp
-            << ": " << entry.message << std::endl;
+  m_logFile << entry.displayLine << '\n';
+  OnFileWritten(entry.displayLine.size() + 1, 1,
+                entry.level == LogLevel::ERROR);
+}
+
+//
+// Bookkeeping after text went to the file: rotate once the file is full,
+// otherwise flush if the flush policy says so. urgent is set when the text
+// contains an ERROR entry.
+//
+void Logger::OnFileWritten(size_t bytes, size_t entries, bool urgent) {
+  m_fileBytes += bytes;
+  m_unflushedEntries += entries;
+
+  if (m_rotationPolicy.maxFileBytes > 0 &&
+      m_fileBytes >= m_rotationPolicy.maxFileBytes) {
+    RotateLogFile();
+    return;
+  }
+  FlushFileIfDue(urgent && m_flushPolicy.onError);
+}
+
+void Logger::FlushFileIfDue(bool force) {
+  auto now = std::chrono::steady_clock::now();
+  bool due = force ||
+             (m_flushPolicy.everyEntries > 0 &&
+              m_unflushedEntries >= m_flushPolicy.everyEntries) ||
+             (m_flushPolicy.everyMs > 0 && m_unflushedEntries > 0 &&
+              now - m_lastFileFlush >=
+                  std::chrono::milliseconds(m_flushPolicy.everyMs));
+  if (!due) {
+    return;
+  }
   m_logFile.flush();
+  m_unflushedEntries = 0;
+  m_lastFileFlush = now;
 }
 
-const std::vector<LogEntry> &Logger::GetLogEntries() const {
-  return m_logEntries;
+//
+// application.log -> application.log.1 -> ... -> application.log.N, the
+// oldest copy is deleted. Runs on the writer thread in async mode, so the
+// threads that log never wait for it.
+//
+void Logger::RotateLogFile() {
+  namespace fs = std::filesystem;
+
+  m_logFile.close();
+
+  std::error_code error;
+  int backups = m_rotationPolicy.maxBackups;
+  for (int i = backups; i >= 1; i--) {
+    fs::path to = m_logFilename + "." + std::to_string(i);
+    fs::path from =
+        i == 1 ? fs::path(m_logFilename)
+               : fs::path(m_logFilename + "." + std::to_string(i - 1));
+    if (i == backups) {
+      fs::remove(to, error);
+    }
+    fs::rename(from, to, error);
+  }
+
+  // with no backups the file just starts over
+  m_logFile.open(m_logFilename, std::ios::out | std::ios::trunc);
+  m_fileBytes = 0;
+  m_unflushedEntries = 0;
+  m_lastFileFlush = std::chrono::steady_clock::now();
+  if (!m_logFile.is_open()) {
+    std::cerr << "Failed to reopen log file after rotation: " << m_logFilename
+              << std::endl;
+    m_fileLoggingEnabled = false;
+  }
+}
+
+void Logger::EnqueueEntry(LogEntry &&entry) {
+  while (!m_queue.TryPush(std::move(entry))) {
+    LogOverflowPolicy policy = m_overflowPolicy;
+    if (policy == LogOverflowPolicy::BLOCK) {
+      WakeWriter();
+      std::this_thread::yield();
+      continue;
+    }
+    if (policy == LogOverflowPolicy::DROP_AND_COUNT) {
+      m_droppedCount++;
+      // so the drop gets reported even if nothing else is logged
+      WakeWriter();
+    }
+    return;
+  }
+
+  m_enqueuedCount++;
+  WakeWriter();
+}
+
+//
+// The flag is set under m_writerMutex so it can't slip in between the
+// writer finding the queue empty and going to sleep
+//
+void Logger::WakeWriter() {
+  {
+    std::lock_guard<std::mutex> lock(m_writerMutex);
+    m_writerPending = true;
+  }
+  m_writerWake.notify_one();
+}
+
+//
+// Background writer: drains the queue in batches, one file write, one
+// console write and one flush per batch
+//
+void Logger::WriterThread() {
+  std::string buffer;
+  LogEntry entry;
+  uint64_t reportedDrops = 0;
+
+  while (true) {
+    size_t count = 0;
+    bool hasError = false;
+    buffer.clear();
+    while (count < ASYNC_BATCH_SIZE && m_queue.TryPop(entry)) {
+      buffer += entry.displayLine;
+      buffer += '\n';
+      hasError = hasError || entry.level == LogLevel::ERROR;
+      count++;
+    }
+
+    uint64_t dropped = m_droppedCount;
+    if (dropped != reportedDrops) {
+      LogEntry warning(LogLevel::WARNING,
+                       std::to_string(dropped - reportedDrops) +
+                           " log entries dropped, queue full",
+                       LogClock::now());
+      buffer += warning.displayLine;
+      buffer += '\n';
+      reportedDrops = dropped;
+    }
+
+    if (!buffer.empty()) {
+      std::lock_guard<std::mutex> lock(m_fileMutex);
+      if (m_fileLoggingEnabled && m_logFile.is_open()) {
+        m_logFile.write(buffer.data(), (std::streamsize)buffer.size());
+        OnFileWritten(buffer.size(), count > 0 ? count : 1, hasError);
+      }
+      std::cout.write(buffer.data(), (std::streamsize)buffer.size());
+      std::cout.flush();
+    }
+
+    if (count > 0) {
+      {
+        std::lock_guard<std::mutex> lock(m_writerMutex);
+        m_writtenCount += count;
+      }
+      m_writerDone.notify_all();
+      continue;
+    }
+
+    // Queue is empty: leave if asked to, otherwise sleep until a producer
+    // wakes us. Only unflushed text needs a timed wake-up, for the flush
+    // policy's deadline.
+    if (m_stopWriter) {
+      break;
+    }
+    bool flushPending = false;
+    std::chrono::steady_clock::time_point flushDeadline;
+    {
+      std::lock_guard<std::mutex> lock(m_fileMutex);
+      if (m_logFile.is_open()) {
+        FlushFileIfDue(false);
+        flushPending = m_flushPolicy.everyMs > 0 && m_unflushedEntries > 0;
+        flushDeadline = m_lastFileFlush +
+                        std::chrono::milliseconds(m_flushPolicy.everyMs);
+      }
+    }
+    std::unique_lock<std::mutex> lock(m_writerMutex);
+    auto woken = [this] { return m_writerPending || m_stopWriter; };
+    if (flushPending) {
+      m_writerWake.wait_until(lock, flushDeadline, woken);
+    } else {
+      m_writerWake.wait(lock, woken);
+    }
+    m_writerPending = false;
+  }
+}
+
+void Logger::StopWriter() {
+  if (!m_writerThread.joinable()) {
+    return;
+  }
+
+  // New entries go straight to the file from here on. Both flags change
+  // under m_writerMutex so a waiting writer or Flush can't miss them.
+  {
+    std::lock_guard<std::mutex> lock(m_writerMutex);
+    m_asyncMode = false;
+    m_stopWriter = true;
+  }
+  m_writerWake.notify_one();
+  m_writerThread.join();
+
+  // Pick up anything a producer queued while the writer was exiting. Keep
+  // draining until producers that saw async mode still on are done, which
+  // also makes room for any of them blocked on a full queue.
+  uint64_t drained = 0;
+  {
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    LogEntry entry;
+    while (true) {
+      bool producersDone = m_asyncProducers.load() == 0;
+      while (m_queue.TryPop(entry)) {
+        if (m_fileLoggingEnabled) {
+          WriteToFile(entry);
+        }
+        std::cout << entry.displayLine << "\n";
+        drained++;
+      }
+      if (producersDone) {
+        break;
+      }
+      std::this_thread::yield();
+    }
+    std::cout.flush();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_writerMutex);
+    m_writtenCount += drained;
+  }
+  m_writerDone.notify_all();
+}
+
+std::vector<LogEntryPtr> Logger::GetLogEntries() const {
+  std::vector<LogEntryPtr> entries;
+  m_logEntries.ReadSince(0, entries);
+  return entries;
+}
+
+uint64_t Logger::ReadLogEntriesSince(uint64_t sequence,
+                                     std::vector<LogEntryPtr> &out) const {
+  return m_logEntries.ReadSince(sequence, out);
+}
+
+uint64_t Logger::GetFirstLogSequence() const {
+  return m_logEntries.GetFirstSequence();
 }
 
 void Logger::ClearLogs() {
   std::lock_guard<std::mutex> lock(m_logMutex);
-  m_logEntries.clear();
+  m_logEntries.Clear();
+  m_dirty.store(true, std::memory_order_relaxed);
+}
+
+void Logger::SetMaxLogEntries(size_t count) {
+  std::lock_guard<std::mutex> lock(m_logMutex);
+  m_logEntries.SetCapacity(count);
+}
+
+size_t Logger::GetMaxLogEntries() const { return m_logEntries.Capacity(); }
+
+std::string_view Logger::GetLogLevelName(LogLevel level) {
+  return LogLevelName(level);
 }
 
 std::string Logger::GetLogLevelString(LogLevel level) const {
-  switch (level) {
-  case LogLevel::INFO:
-    return "INFO";
-  case LogLevel::WARNING:
-    return "WARN";
-  case LogLevel::ERROR:
-    return "ERROR";
-  case LogLevel::DEBUG:
-    return "DEBUG";
-  case LogLevel::GAME_EVENT:
-    return "GAME";
-  default:
-    return "UNKNOWN";
-  }
+  return std::string(GetLogLevelName(level));
 }
 
 std::string Logger::GetCurrentTimestamp() const {
-  auto now = std::chrono::system_clock::now();
-  auto time_t = std::chrono::system_clock::to_time_t(now);
-  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                now.time_since_epoch()) %
-            1000;
+  return FormatTimestamp(LogClock::now());
+}
+
+std::string Logger::FormatTimestamp(LogClock::time_point time) {
+  // "HH:MM:SS" for the second last formatted on this thread
+  thread_local std::time_t cachedSecond = -1;
+  thread_local char cachedPrefix[9] = {};
 
-  std::stringstream ss;
-  ss << std::put_time(std::localtime(&time_t), "%H:%M:%S");
-  ss << '.' << std::setfill('0') << std::setw(3) << ms.count();
+  auto sinceEpoch = std::chrono::duration_cast<std::chrono::milliseconds>(
+      time.time_since_epoch());
+  long long ms = sinceEpoch.count() % 1000;
+  if (ms < 0) {
+    ms += 1000;
+  }
+  std::time_t second =
+      LogClock::to_time_t(time - std::chrono::milliseconds(ms));
+
+  if (second != cachedSecond) {
+    std::tm local = {};
+#ifdef _WIN32
+    localtime_s(&local, &second);
+#else
+    localtime_r(&second, &local);
+#endif
+    std::strftime(cachedPrefix, sizeof(cachedPrefix), "%H:%M:%S", &local);
+    cachedSecond = second;
+  }
 
-  return ss.str();
+  // 12 characters, fits the small string buffer so no heap allocation
+  char text[13];
+  std::memcpy(text, cachedPrefix, 8);
+  text[8] = '.';
+  text[9] = (char)('0' + ms / 100);
+  text[10] = (char)('0' + ms / 10 % 10);
+  text[11] = (char)('0' + ms % 10);
+  text[12] = '\0';
+  return std::string(text, 12);
 }
 
 } // namespace ClassGame
@@ -1,22 +1,61 @@
 #pragma once
 
+#include "BoundedQueue.h"
+#include "LogFormat.h"
+#include "LogHistory.h"
+#include "LogLevel.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <fstream>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
 namespace ClassGame {
 
-enum class LogLevel { INFO, WARNING, ERROR, DEBUG, GAME_EVENT };
+using LogClock = std::chrono::system_clock;
 
 struct LogEntry {
   LogLevel level;
   std::string message;
+  // when the entry was logged, for callers that format time themselves
+  LogClock::time_point time;
   std::string timestamp;
+  // "[LEVEL] timestamp: message", built once when the entry is logged
+  std::string displayLine;
+  // position in the in-memory history, see LogHistory
+  uint64_t sequence = 0;
 
-  LogEntry(LogLevel l, const std::string &msg, const std::string &ts)
-      : level(l), message(msg), timestamp(ts) {}
+  LogEntry() : level(LogLevel::INFO) {}
+  LogEntry(LogLevel l, const std::string &msg, LogClock::time_point t);
+};
+
+// What an asynchronous log call does when the writer queue is full
+enum class LogOverflowPolicy {
+  BLOCK,         // wait for the writer to make room
+  DROP,          // discard the entry silently
+  DROP_AND_COUNT // discard the entry and report the total in the log
+};
+
+// When the log file is rotated: once it reaches maxFileBytes it becomes
+// "<file>.1", older copies shift up to "<file>.<maxBackups>" and the oldest
+// is deleted, so disk use stays under (maxBackups + 1) * maxFileBytes
+struct LogRotationPolicy {
+  uint64_t maxFileBytes = 1024 * 1024; // 0 never rotates
+  int maxBackups = 5;
+};
+
+// When written entries are flushed to disk; whichever trigger comes first.
+// A zero count or interval turns that trigger off.
+struct LogFlushPolicy {
+  size_t everyEntries = 64;
+  int everyMs = 1000;
+  bool onError = true; // flush straight away after an ERROR entry
 };
 
 class Logger {
@@ -38,32 +77,158 @@ public:
   void LogDebug(const std::string &message);
   void LogGameEvent(const std::string &message);
 
+  // Format and log a message, e.g. Log(LogLevel::INFO, "turn {}", turn).
+  // Nothing is formatted when the level is below the runtime threshold;
+  // prefer the LOG_* macros, which also skip evaluating the arguments.
+  template <typename... Args>
+  void Log(LogLevel level, LogFormatString<Args...> format, Args &&...args) {
+    if (!IsEnabled(level)) {
+      return;
+    }
+    AddLogEntry(level, FormatLogMessage(format, std::forward<Args>(args)...));
+  }
+
+  // Runtime threshold: levels less severe than this are discarded
+  void SetMinLevel(LogLevel level) { m_minSeverity = LogLevelSeverity(level); }
+  bool IsEnabled(LogLevel level) const {
+    return LogLevelSeverity(level) >=
+           m_minSeverity.load(std::memory_order_relaxed);
+  }
+
   // File logging control
   void SetLogFile(const std::string &filename);
   void EnableFileLogging(bool enable);
-
-  // ImGui console access
-  const std::vector<LogEntry> &GetLogEntries() const;
+  void SetRotationPolicy(const LogRotationPolicy &policy);
+  void SetFlushPolicy(const LogFlushPolicy &policy);
+
+  // Asynchronous mode: callers only queue the entry, file and console output
+  // are batched by a background writer thread
+  void SetAsyncMode(bool enable);
+  bool IsAsyncMode() const { return m_asyncMode; }
+  void SetOverflowPolicy(LogOverflowPolicy policy);
+  uint64_t GetDroppedCount() const { return m_droppedCount; }
+  // Block until everything queued so far has been written, then flush the
+  // file regardless of the flush policy
+  void Flush();
+
+  // ImGui console access, none of these block the threads that log
+  // Copy of the whole history, oldest first
+  std::vector<LogEntryPtr> GetLogEntries() const;
+  // Append the entries logged since sequence to out and return the sequence
+  // to pass next time, e.g. once per frame to only pick up new entries
+  uint64_t ReadLogEntriesSince(uint64_t sequence,
+                               std::vector<LogEntryPtr> &out) const;
+  // Oldest sequence still in the history; anything before it was evicted or
+  // cleared
+  uint64_t GetFirstLogSequence() const;
   void ClearLogs();
+  // True once after the history changed, so the render loop can tell whether
+  // the console has anything new to show; any thread may log, one reader
+  // takes the flag
+  bool TakeDirty() { return m_dirty.exchange(false, std::memory_order_relaxed); }
+  // Number of entries kept in memory, the oldest are dropped first
+  void SetMaxLogEntries(size_t count);
+  size_t GetMaxLogEntries() const;
 
   // Utility
+  static std::string_view GetLogLevelName(LogLevel level);
   std::string GetLogLevelString(LogLevel level) const;
   std::string GetCurrentTimestamp() const;
+  // Local "HH:MM:SS.mmm" for a point in time. Thread-safe; the "HH:MM:SS"
+  // part is cached per thread and only rebuilt when the second changes.
+  static std::string FormatTimestamp(LogClock::time_point time);
 
 private:
   Logger();
 
   void AddLogEntry(LogLevel level, const std::string &message);
+  // File output, callers hold m_fileMutex
   void WriteToFile(const LogEntry &entry);
-
-  std::vector<LogEntry> m_logEntries;
+  void OnFileWritten(size_t bytes, size_t entries, bool urgent);
+  void FlushFileIfDue(bool force);
+  void RotateLogFile();
+  void EnqueueEntry(LogEntry &&entry);
+  void WakeWriter();
+  void WriterThread();
+  void StopWriter();
+
+  LogHistory m_logEntries;
   std::ofstream m_logFile;
   std::string m_logFilename;
   bool m_fileLoggingEnabled;
+  // serializes ClearLogs and SetMaxLogEntries; appends and readers don't
+  // take it
   std::mutex m_logMutex;
-
-  // Maximum number of log entries to keep in memory (for ImGui display)
+  // guards m_logFile and console output
+  std::mutex m_fileMutex;
+  LogRotationPolicy m_rotationPolicy;
+  LogFlushPolicy m_flushPolicy;
+  uint64_t m_fileBytes = 0;
+  size_t m_unflushedEntries = 0;
+  std::chrono::steady_clock::time_point m_lastFileFlush;
+
+  // Asynchronous writer
+  BoundedQueue<LogEntry> m_queue;
+  std::thread m_writerThread;
+  std::atomic<bool> m_asyncMode;
+  // producers between checking m_asyncMode and finishing their push
+  std::atomic<int> m_asyncProducers{0};
+  std::atomic<bool> m_stopWriter;
+  std::atomic<LogOverflowPolicy> m_overflowPolicy;
+  std::atomic<uint64_t> m_droppedCount;
+  std::atomic<uint64_t> m_enqueuedCount;
+  std::atomic<uint64_t> m_writtenCount;
+  // set by producers under m_writerMutex, the writer sleeps until it is
+  bool m_writerPending = false;
+  std::mutex m_writerMutex;
+  std::condition_variable m_writerWake;
+  std::condition_variable m_writerDone;
+
+  // LogLevelSeverity of the least severe level that is kept
+  std::atomic<int> m_minSeverity{0};
+  // set whenever the history changes, cleared by TakeDirty
+  std::atomic<bool> m_dirty{true};
+
+  // Default number of log entries to keep in memory (for ImGui display)
   static const size_t MAX_LOG_ENTRIES = 1000;
+  // Entries that can wait for the writer thread before the overflow policy
+  // kicks in
+  static const size_t ASYNC_QUEUE_CAPACITY = 4096;
+  // Most entries the writer formats before touching the file and console
+  static const size_t ASYNC_BATCH_SIZE = 256;
 };
 
 } // namespace ClassGame
+
+//
+// Logging front end
+//
+// LOG_INFO("Winner: Player {}", winner) checks the level before anything is
+// formatted or evaluated. Levels below LOG_MIN_SEVERITY (see
+// LogLevelSeverity) are removed at compile time; release builds drop DEBUG
+// unless LOG_MIN_SEVERITY is defined otherwise.
+//
+#ifndef LOG_MIN_SEVERITY
+#ifdef NDEBUG
+#define LOG_MIN_SEVERITY 1
+#else
+#define LOG_MIN_SEVERITY 0
+#endif
+#endif
+
+#define LOG_AT(level, ...)                                                     \
+  do {                                                                         \
+    if constexpr (::ClassGame::LogLevelSeverity(level) >= LOG_MIN_SEVERITY) {  \
+      ::ClassGame::Logger &logger_ = ::ClassGame::Logger::GetInstance();       \
+      if (logger_.IsEnabled(level)) {                                          \
+        logger_.Log(level, __VA_ARGS__);                                       \
+      }                                                                        \
+    }                                                                          \
+  } while (0)
+
+#define LOG_DEBUG(...) LOG_AT(::ClassGame::LogLevel::DEBUG, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(::ClassGame::LogLevel::INFO, __VA_ARGS__)
+#define LOG_GAME_EVENT(...)                                                    \
+  LOG_AT(::ClassGame::LogLevel::GAME_EVENT, __VA_ARGS__)
+#define LOG_WARNING(...) LOG_AT(::ClassGame::LogLevel::WARNING, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(::ClassGame::LogLevel::ERROR, __VA_ARGS__)
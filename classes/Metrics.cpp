@@ -0,0 +1,193 @@
+#include "Metrics.h"
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace ClassGame {
+
+void Gauge::Add(double amount) {
+  double value = m_value.load(std::memory_order_relaxed);
+  while (!m_value.compare_exchange_weak(value, value + amount,
+                                        std::memory_order_relaxed)) {
+  }
+}
+
+int LatencyHistogram::BucketFor(uint64_t value) {
+  if (value < (1u << SUB_BITS)) {
+    return (int)value;
+  }
+  int exponent = std::bit_width(value) - 1;
+  int sub = (int)((value >> (exponent - SUB_BITS)) & ((1u << SUB_BITS) - 1));
+  return ((exponent - SUB_BITS + 1) << SUB_BITS) + sub;
+}
+
+uint64_t LatencyHistogram::BucketLimit(int bucket) {
+  if (bucket < (1 << SUB_BITS)) {
+    return (uint64_t)bucket;
+  }
+  int exponent = (bucket >> SUB_BITS) + SUB_BITS - 1;
+  uint64_t sub = (uint64_t)(bucket & ((1 << SUB_BITS) - 1));
+  uint64_t base = (1ull << exponent) | (sub << (exponent - SUB_BITS));
+  return base + (1ull << (exponent - SUB_BITS)) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t nanoseconds) {
+  m_buckets[BucketFor(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+  m_count.fetch_add(1, std::memory_order_relaxed);
+  m_sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+  uint64_t max = m_max.load(std::memory_order_relaxed);
+  while (nanoseconds > max &&
+         !m_max.compare_exchange_weak(max, nanoseconds,
+                                      std::memory_order_relaxed)) {
+  }
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram &other) {
+  for (int i = 0; i < BUCKETS; i++) {
+    uint64_t count = other.m_buckets[i].load(std::memory_order_relaxed);
+    if (count) {
+      m_buckets[i].fetch_add(count, std::memory_order_relaxed);
+    }
+  }
+  m_count.fetch_add(other.Count(), std::memory_order_relaxed);
+  m_sum.fetch_add(other.Sum(), std::memory_order_relaxed);
+  uint64_t otherMax = other.Max();
+  uint64_t max = m_max.load(std::memory_order_relaxed);
+  while (otherMax > max &&
+         !m_max.compare_exchange_weak(max, otherMax,
+                                      std::memory_order_relaxed)) {
+  }
+}
+
+uint64_t LatencyHistogram::Percentile(double p) const {
+  uint64_t total = Count();
+  if (total == 0) {
+    return 0;
+  }
+  uint64_t rank = (uint64_t)(p / 100.0 * (double)(total - 1)) + 1;
+  uint64_t seen = 0;
+  for (int i = 0; i < BUCKETS; i++) {
+    seen += m_buckets[i].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      return std::min(BucketLimit(i), Max());
+    }
+  }
+  return Max();
+}
+
+Metrics &Metrics::GetInstance() {
+  static Metrics instance;
+  return instance;
+}
+
+template <typename T>
+T &Metrics::GetOrCreate(std::map<std::string, Entry<T>> &metrics,
+                        const std::string &name, const std::string &help) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Entry<T> &entry = metrics[name];
+  if (!entry.metric) {
+    entry.metric = std::make_unique<T>();
+    entry.help = help;
+  }
+  return *entry.metric;
+}
+
+Counter &Metrics::GetCounter(const std::string &name,
+                             const std::string &help) {
+  return GetOrCreate(m_counters, name, help);
+}
+
+Gauge &Metrics::GetGauge(const std::string &name, const std::string &help) {
+  return GetOrCreate(m_gauges, name, help);
+}
+
+LatencyHistogram &Metrics::GetHistogram(const std::string &name,
+                                        const std::string &help) {
+  return GetOrCreate(m_histograms, name, help);
+}
+
+static void appendHeader(std::string &out, const std::string &name,
+                         const std::string &help, const char *type) {
+  if (!help.empty()) {
+    out += "# HELP " + name + " " + help + "\n";
+  }
+  out += "# TYPE " + name + " " + type + "\n";
+}
+
+static void appendValue(std::string &out, const std::string &name,
+                        double value) {
+  char text[64];
+  snprintf(text, sizeof(text), " %.9g\n", value);
+  out += name;
+  out += text;
+}
+
+std::string Metrics::PrometheusText() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::string out;
+
+  for (const auto &[name, entry] : m_counters) {
+    appendHeader(out, name, entry.help, "counter");
+    appendValue(out, name, (double)entry.metric->Value());
+  }
+  for (const auto &[name, entry] : m_gauges) {
+    appendHeader(out, name, entry.help, "gauge");
+    appendValue(out, name, entry.metric->Value());
+  }
+  const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+  for (const auto &[name, entry] : m_histograms) {
+    const LatencyHistogram &histogram = *entry.metric;
+    appendHeader(out, name, entry.help, "summary");
+    for (double quantile : quantiles) {
+      char label[32];
+      snprintf(label, sizeof(label), "{quantile=\"%g\"}", quantile);
+      appendValue(out, name + label,
+                  (double)histogram.Percentile(quantile * 100.0) / 1e9);
+    }
+    appendValue(out, name + "_sum", (double)histogram.Sum() / 1e9);
+    appendValue(out, name + "_count", (double)histogram.Count());
+  }
+  return out;
+}
+
+bool Metrics::WritePrometheusFile(const std::string &filename) const {
+  std::string text = PrometheusText();
+
+  // write a temporary file and rename it so a scraper never sees half a dump
+  std::string temporary = filename + ".tmp";
+  {
+    std::ofstream file(temporary, std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+      return false;
+    }
+    file << text;
+    if (!file.good()) {
+      return false;
+    }
+  }
+  std::error_code error;
+  std::filesystem::rename(temporary, filename, error);
+  return !error;
+}
+
+void Metrics::SetDumpFile(const std::string &filename, int intervalMs) {
+  m_dumpFile = filename;
+  m_dumpIntervalMs = intervalMs;
+  m_lastDump = std::chrono::steady_clock::now();
+}
+
+void Metrics::Tick() {
+  if (m_dumpFile.empty() || m_dumpIntervalMs <= 0) {
+    return;
+  }
+  auto now = std::chrono::steady_clock::now();
+  if (now - m_lastDump < std::chrono::milliseconds(m_dumpIntervalMs)) {
+    return;
+  }
+  m_lastDump = now;
+  WritePrometheusFile(m_dumpFile);
+}
+
+} // namespace ClassGame
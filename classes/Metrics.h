@@ -0,0 +1,170 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace ClassGame {
+
+//
+// Counters, gauges and latency histograms for the game, next to the Logger
+//
+// Recording never takes a lock: every metric is a set of relaxed atomics.
+// Looking a metric up by name does lock the registry, so hot paths keep the
+// reference in a function-local static:
+//
+//   static Counter &turns = Metrics::GetInstance().GetCounter(
+//       "game_turns_total", "Turns played");
+//   turns.Add();
+//
+
+// Monotonically increasing count
+class Counter {
+public:
+  void Add(uint64_t amount = 1) {
+    m_value.fetch_add(amount, std::memory_order_relaxed);
+  }
+  uint64_t Value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<uint64_t> m_value{0};
+};
+
+// Value that can go up and down
+class Gauge {
+public:
+  void Set(double value) { m_value.store(value, std::memory_order_relaxed); }
+  void Add(double amount);
+  double Value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<double> m_value{0.0};
+};
+
+//
+// HDR-style latency histogram in nanoseconds: log-linear buckets with 16
+// sub-buckets per power of two, so any percentile is within ~6% of the true
+// value over the full 64-bit range, in a fixed 8 KB of counters
+//
+class LatencyHistogram {
+public:
+  static constexpr int SUB_BITS = 4;
+  static constexpr int BUCKETS = 64 << SUB_BITS;
+
+  void Record(uint64_t nanoseconds);
+  // add another histogram's samples, e.g. per-thread ones at the end of a run
+  void Merge(const LatencyHistogram &other);
+
+  uint64_t Count() const { return m_count.load(std::memory_order_relaxed); }
+  uint64_t Sum() const { return m_sum.load(std::memory_order_relaxed); }
+  uint64_t Max() const { return m_max.load(std::memory_order_relaxed); }
+  // p in [0, 100], 0 when empty
+  uint64_t Percentile(double p) const;
+
+  static int BucketFor(uint64_t value);
+  // largest value that lands in a bucket
+  static uint64_t BucketLimit(int bucket);
+
+private:
+  std::atomic<uint64_t> m_buckets[BUCKETS] = {};
+  std::atomic<uint64_t> m_count{0};
+  std::atomic<uint64_t> m_sum{0};
+  std::atomic<uint64_t> m_max{0};
+};
+
+// Records the time from construction to destruction into a histogram
+class ScopedLatency {
+public:
+  explicit ScopedLatency(LatencyHistogram &histogram)
+      : m_histogram(histogram), m_start(std::chrono::steady_clock::now()) {}
+  ~ScopedLatency() {
+    m_histogram.Record(
+        (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - m_start)
+            .count());
+  }
+
+  ScopedLatency(const ScopedLatency &) = delete;
+  ScopedLatency &operator=(const ScopedLatency &) = delete;
+
+private:
+  LatencyHistogram &m_histogram;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+class Metrics {
+public:
+  // Singleton pattern, like Logger
+  static Metrics &GetInstance();
+
+  Metrics(const Metrics &) = delete;
+  Metrics &operator=(const Metrics &) = delete;
+
+  // Find or create a metric. Names follow Prometheus conventions
+  // (snake_case, counters end in _total). The references stay valid for the
+  // life of the program.
+  Counter &GetCounter(const std::string &name, const std::string &help = "");
+  Gauge &GetGauge(const std::string &name, const std::string &help = "");
+  LatencyHistogram &GetHistogram(const std::string &name,
+                                 const std::string &help = "");
+
+  // Call fn(name, metric) for every metric of a kind, sorted by name
+  template <typename Fn> void ForEachCounter(Fn &&fn) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto &[name, entry] : m_counters) {
+      fn(name, *entry.metric);
+    }
+  }
+  template <typename Fn> void ForEachGauge(Fn &&fn) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto &[name, entry] : m_gauges) {
+      fn(name, *entry.metric);
+    }
+  }
+  template <typename Fn> void ForEachHistogram(Fn &&fn) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto &[name, entry] : m_histograms) {
+      fn(name, *entry.metric);
+    }
+  }
+
+  // Prometheus text exposition format; histograms are written as summaries
+  // (quantiles, _sum and _count) in seconds
+  std::string PrometheusText() const;
+  // Write PrometheusText() to a file, replacing it in one step
+  bool WritePrometheusFile(const std::string &filename) const;
+
+  // Periodic dumps: Tick() is called once per frame and writes the file
+  // every intervalMs; an empty filename turns dumping off
+  void SetDumpFile(const std::string &filename, int intervalMs);
+  const std::string &GetDumpFile() const { return m_dumpFile; }
+  void Tick();
+
+private:
+  Metrics() = default;
+
+  template <typename T> struct Entry {
+    std::string help;
+    std::unique_ptr<T> metric;
+  };
+
+  template <typename T>
+  T &GetOrCreate(std::map<std::string, Entry<T>> &metrics,
+                 const std::string &name, const std::string &help);
+
+  // guards the maps, not the metrics themselves
+  mutable std::mutex m_mutex;
+  std::map<std::string, Entry<Counter>> m_counters;
+  std::map<std::string, Entry<Gauge>> m_gauges;
+  std::map<std::string, Entry<LatencyHistogram>> m_histograms;
+
+  std::string m_dumpFile;
+  int m_dumpIntervalMs = 0;
+  std::chrono::steady_clock::time_point m_lastDump;
+};
+
+} // namespace ClassGame
@@ -1,5 +1,8 @@
 #pragma once
+#include <cstdint>
+#include <string>
 #include "Entity.h"
+#include "SpriteBatch.h"
 #include "../imgui/imgui.h"
 
 class Sprite : public Entity
@@ -16,11 +19,19 @@ public:
         _scale(1),
         _color(1, 1, 1, 1),
         _localZOrder(0),
+        _texture(0),
+        _uv0(0, 0),
+        _uv1(1, 1),
         _highlighted(false)
         { 
             _entityType = EntitySprite;
         };
-    ~Sprite() { if (_retainCount > 0) release(); }
+    ~Sprite();
+
+    // we hold a counted TextureCache reference that ~Sprite gives back, a copy would give it
+    // back a second time
+    Sprite(const Sprite &) = delete;
+    Sprite &operator=(const Sprite &) = delete;
     
     // set the texture to use for this sprite
     void setPosition(float x, float y)
@@ -61,7 +72,15 @@ public:
         {
             ImGui::SetCursorPos(_location);
             ImVec4 highlight = _highlighted ? ImVec4(1, 1, 0, 1) : ImVec4(0, 0, 0, 0);
-            ImGui::Image((void*)(intptr_t)_texture, _size, ImVec2(0, 0), ImVec2(1, 1), _color, highlight);
+            ImGui::Image((void*)(intptr_t)_texture, _size, _uv0, _uv1, _color, highlight);
+        }
+    }
+    // queue the sprite as a plain quad, drawn on the given layer when the batch is
+    void batchSprite(SpriteBatch &batch, int layer)
+    {
+        if (_size.x > 0.0f && _size.y > 0.0f)
+        {
+            batch.add(layer, _texture, _location, _size, _uv0, _uv1, _color, _highlighted);
         }
     }
 	// is the mouse over this position?
@@ -70,6 +89,8 @@ public:
         return (mousePos.x >= _location.x && mousePos.x <= _location.x + _size.x && mousePos.y >= _location.y && mousePos.y <= _location.y + _size.y);
     }
 
+    // textures come from the shared TextureCache, loading the same file twice reuses the texture
+    // and images in the atlas only point at their part of a shared page
     bool LoadTextureFromFile(const char* filename);
 	
     // set the highlighted state
@@ -95,10 +116,15 @@ private:
     ImVec4  _color;
     // the local Z order
     int _localZOrder;
-    // the texture we're going to draw
+    // the texture we're going to draw, a whole image or an atlas page
     ImTextureID _texture;
+    // the part of _texture holding our image
+    ImVec2  _uv0;
+    ImVec2  _uv1;
     // currently highlighted
    	bool	_highlighted;
-    // private platform specific texture loading
-    ImTextureID _loadTextureFromMemory(const unsigned char *image_data, int image_width, int image_height);
+    // cache key for _texture, empty if we don't hold a counted reference (none, or an atlas page)
+    std::string _texturePath;
+    // give our texture reference back to the cache
+    void releaseTexture();
 };
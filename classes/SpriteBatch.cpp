@@ -0,0 +1,104 @@
+#include "SpriteBatch.h"
+#include <algorithm>
+
+// matches the ImGui::Image border Sprite::paintSprite draws around highlighted sprites
+static const ImVec4 HIGHLIGHT_COLOR = ImVec4(1, 1, 0, 1);
+
+void SpriteBatch::add(int layer, ImTextureID texture, const ImVec2 &position, const ImVec2 &size,
+                      const ImVec2 &uv0, const ImVec2 &uv1, const ImVec4 &color, bool highlighted)
+{
+    Quad quad;
+    quad.layer = layer;
+    quad.texture = texture;
+    quad.min = position;
+    // a highlight border sits around the image, pushing it in by a pixel like ImGui::Image does
+    quad.max = ImVec2(position.x + size.x + (highlighted ? 2.0f : 0.0f),
+                      position.y + size.y + (highlighted ? 2.0f : 0.0f));
+    quad.uv0 = uv0;
+    quad.uv1 = uv1;
+    quad.color = ImGui::GetColorU32(color);
+    quad.highlighted = highlighted;
+    _quads.push_back(quad);
+}
+
+static bool drawsBefore(const SpriteBatch::Quad &a, const SpriteBatch::Quad &b)
+{
+    if (a.layer != b.layer) {
+        return a.layer < b.layer;
+    }
+    return a.texture < b.texture;
+}
+
+void SpriteBatch::draw()
+{
+    if (_quads.empty()) {
+        return;
+    }
+
+    ImDrawList *drawList = ImGui::GetWindowDrawList();
+    ImVec2 origin = ImGui::GetWindowPos();
+    origin.x -= ImGui::GetScrollX();
+    origin.y -= ImGui::GetScrollY();
+    ImVec2 clipMin = drawList->GetClipRectMin();
+    ImVec2 clipMax = drawList->GetClipRectMax();
+
+    // move to screen space and drop what the window can't show, before any sorting
+    ImVec2 extent(0, 0);
+    size_t visible = 0;
+    for (const Quad &quad : _quads) {
+        extent.x = std::max(extent.x, quad.max.x);
+        extent.y = std::max(extent.y, quad.max.y);
+        ImVec2 min(origin.x + quad.min.x, origin.y + quad.min.y);
+        ImVec2 max(origin.x + quad.max.x, origin.y + quad.max.y);
+        if (max.x < clipMin.x || min.x > clipMax.x || max.y < clipMin.y || min.y > clipMax.y) {
+            continue;
+        }
+        Quad &kept = _quads[visible++];
+        kept = quad;
+        kept.min = min;
+        kept.max = max;
+    }
+    _quads.resize(visible);
+
+    // stable so sprites in the same layer and texture keep the order they were added in
+    if (!std::is_sorted(_quads.begin(), _quads.end(), drawsBefore)) {
+        std::stable_sort(_quads.begin(), _quads.end(), drawsBefore);
+    }
+
+    ImU32 highlightColor = ImGui::GetColorU32(HIGHLIGHT_COLOR);
+    size_t start = 0;
+    while (start < _quads.size()) {
+        // one run of quads on the same layer and texture
+        size_t end = start + 1;
+        while (end < _quads.size() && _quads[end].layer == _quads[start].layer &&
+               _quads[end].texture == _quads[start].texture) {
+            end++;
+        }
+
+        drawList->PushTexture(ImTextureRef(_quads[start].texture));
+        drawList->PrimReserve((int)(end - start) * 6, (int)(end - start) * 4);
+        for (size_t i = start; i < end; i++) {
+            const Quad &quad = _quads[i];
+            if (quad.highlighted) {
+                drawList->PrimRectUV(ImVec2(quad.min.x + 1.0f, quad.min.y + 1.0f),
+                                     ImVec2(quad.max.x - 1.0f, quad.max.y - 1.0f),
+                                     quad.uv0, quad.uv1, quad.color);
+            } else {
+                drawList->PrimRectUV(quad.min, quad.max, quad.uv0, quad.uv1, quad.color);
+            }
+        }
+        drawList->PopTexture();
+
+        // borders are untextured, they go after the run so they don't split it
+        for (size_t i = start; i < end; i++) {
+            if (_quads[i].highlighted) {
+                drawList->AddRect(_quads[i].min, _quads[i].max, highlightColor);
+            }
+        }
+        start = end;
+    }
+
+    ImGui::SetCursorPos(ImVec2(0, 0));
+    ImGui::Dummy(extent);
+    _quads.clear();
+}
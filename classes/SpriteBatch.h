@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "../imgui/imgui.h"
+
+class SpriteBatch
+{
+    // collects sprites for one window and writes them into its ImDrawList as plain textured
+    // quads, instead of registering an ImGui item (ID, layout, clipping) for each one.
+    // quads are sorted by layer and then texture, so a board whose sprites share an atlas page
+    // reaches the GPU as one draw call per layer or fewer.
+
+public:
+    // position is window-local, like Sprite's; higher layers draw on top of lower ones
+    void add(int layer, ImTextureID texture, const ImVec2 &position, const ImVec2 &size,
+             const ImVec2 &uv0, const ImVec2 &uv1, const ImVec4 &color, bool highlighted);
+
+    // draw everything into the current window and empty the batch. a single dummy item covers
+    // the sprites so the window still knows its content size.
+    void draw();
+
+    size_t size() const { return _quads.size(); }
+
+    struct Quad
+    {
+        int layer;
+        ImTextureID texture;
+        ImVec2 min;
+        ImVec2 max;
+        ImVec2 uv0;
+        ImVec2 uv1;
+        ImU32 color;
+        bool highlighted;
+    };
+
+private:
+    // kept between frames so a steady board doesn't allocate
+    std::vector<Quad> _quads;
+};
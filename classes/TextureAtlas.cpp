@@ -0,0 +1,188 @@
+#include "TextureAtlas.h"
+#include "stb_image.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+
+// imgui_draw.cpp keeps its copy of the packer static, so we compile our own.
+// being static, the helpers we don't call would each warn as unused.
+#if defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-function"
+#elif defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "../imgui/imstb_rectpack.h"
+#if defined(__clang__)
+#pragma clang diagnostic pop
+#elif defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+// pixels of edge copy around every image
+static const int ATLAS_PADDING = 1;
+
+// copy an image into a page at x, y and repeat its outermost pixels into the padding
+static void blitPadded(const AtlasImage &image, AtlasPage &page, int x, int y)
+{
+    for (int row = -ATLAS_PADDING; row < image.height + ATLAS_PADDING; row++) {
+        int srcRow = std::clamp(row, 0, image.height - 1);
+        for (int col = -ATLAS_PADDING; col < image.width + ATLAS_PADDING; col++) {
+            int srcCol = std::clamp(col, 0, image.width - 1);
+            const unsigned char *src = &image.pixels[((size_t)srcRow * image.width + srcCol) * 4];
+            unsigned char *dst = &page.pixels[((size_t)(y + row) * page.width + (x + col)) * 4];
+            memcpy(dst, src, 4);
+        }
+    }
+}
+
+std::vector<AtlasImage> loadAtlasImages(const std::string &directory, unsigned threads)
+{
+    std::vector<std::filesystem::path> files;
+    std::error_code error;
+    for (const auto &file : std::filesystem::directory_iterator(directory, error)) {
+        if (file.path().extension() == ".png") {
+            files.push_back(file.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    // stbi_load keeps no shared state (we never set the global flip flag), so every worker
+    // decodes on its own; each one takes the next file until none are left
+    std::vector<AtlasImage> decoded(files.size());
+    std::atomic<size_t> next(0);
+    auto decode = [&files, &decoded, &next]() {
+        for (size_t i = next++; i < files.size(); i = next++) {
+            int width = 0;
+            int height = 0;
+            unsigned char *data = stbi_load(files[i].string().c_str(), &width, &height, NULL, 4);
+            if (data == NULL) {
+                continue;
+            }
+            AtlasImage &image = decoded[i];
+            image.name = files[i].filename().string();
+            image.width = width;
+            image.height = height;
+            image.pixels.assign(data, data + (size_t)width * height * 4);
+            stbi_image_free(data);
+        }
+    };
+
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = (unsigned)std::min<size_t>(threads, files.size());
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; t++) {
+        workers.emplace_back(decode);
+    }
+    decode();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    std::vector<AtlasImage> images;
+    for (size_t i = 0; i < files.size(); i++) {
+        if (decoded[i].pixels.empty()) {
+            std::cout << "Failed to load texture: " << files[i].string() << std::endl;
+            continue;
+        }
+        images.push_back(std::move(decoded[i]));
+    }
+    return images;
+}
+
+int TextureAtlas::build(const std::vector<AtlasImage> &images, int pageSize)
+{
+    clear();
+
+    std::vector<stbrp_rect> remaining;
+    for (size_t i = 0; i < images.size(); i++) {
+        const AtlasImage &image = images[i];
+        int width = image.width + ATLAS_PADDING * 2;
+        int height = image.height + ATLAS_PADDING * 2;
+        if (image.width <= 0 || image.height <= 0 || width > pageSize || height > pageSize) {
+            continue;
+        }
+        stbrp_rect rect = {};
+        rect.id = (int)i;
+        rect.w = width;
+        rect.h = height;
+        remaining.push_back(rect);
+    }
+
+    std::vector<stbrp_node> nodes(pageSize);
+    while (!remaining.empty()) {
+        stbrp_context context;
+        stbrp_init_target(&context, pageSize, pageSize, nodes.data(), (int)nodes.size());
+        stbrp_pack_rects(&context, remaining.data(), (int)remaining.size());
+
+        // pages are only as tall as what landed on them
+        int usedHeight = 0;
+        for (const stbrp_rect &rect : remaining) {
+            if (rect.was_packed) {
+                usedHeight = std::max(usedHeight, rect.y + rect.h);
+            }
+        }
+
+        int pageIndex = (int)_pages.size();
+        _pages.emplace_back();
+        AtlasPage &page = _pages.back();
+        page.width = pageSize;
+        page.height = usedHeight;
+        page.pixels.assign((size_t)page.width * page.height * 4, 0);
+
+        std::vector<stbrp_rect> unpacked;
+        for (const stbrp_rect &rect : remaining) {
+            if (!rect.was_packed) {
+                unpacked.push_back(rect);
+                continue;
+            }
+            const AtlasImage &image = images[rect.id];
+            int x = rect.x + ATLAS_PADDING;
+            int y = rect.y + ATLAS_PADDING;
+            blitPadded(image, page, x, y);
+
+            AtlasRegion region;
+            region.page = pageIndex;
+            region.x = x;
+            region.y = y;
+            region.size = ImVec2((float)image.width, (float)image.height);
+            region.uv0 = ImVec2((float)x / page.width, (float)y / page.height);
+            region.uv1 = ImVec2((float)(x + image.width) / page.width, (float)(y + image.height) / page.height);
+            _regions[image.name] = region;
+        }
+        remaining.swap(unpacked);
+    }
+    return (int)_regions.size();
+}
+
+bool TextureAtlas::find(const std::string &name, AtlasRegion &region) const
+{
+    auto it = _regions.find(name);
+    if (it == _regions.end()) {
+        return false;
+    }
+    region = it->second;
+    return true;
+}
+
+void TextureAtlas::releasePixels()
+{
+    for (AtlasPage &page : _pages) {
+        page.pixels.clear();
+        page.pixels.shrink_to_fit();
+    }
+}
+
+void TextureAtlas::clear()
+{
+    _pages.clear();
+    _regions.clear();
+}
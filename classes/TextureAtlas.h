@@ -0,0 +1,66 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../imgui/imgui.h"
+
+// width and maximum height of an atlas page, at runtime and in tools/assetbake.cpp
+const int TEXTURE_ATLAS_PAGE_SIZE = 1024;
+
+// one decoded RGBA image going into the atlas
+struct AtlasImage
+{
+    std::string name;
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> pixels;
+};
+
+// where an image ended up: the page it is on, its pixel position and its UV rectangle there
+struct AtlasRegion
+{
+    int page = -1;
+    int x = 0;
+    int y = 0;
+    ImVec2 size;
+    ImVec2 uv0;
+    ImVec2 uv1;
+};
+
+// one RGBA page of packed images, ready to upload as a texture
+struct AtlasPage
+{
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> pixels;
+};
+
+// decode every PNG in a directory to RGBA, sorted by file name, spread over threads workers
+// (0 for one per core). files that fail to decode are reported and skipped.
+std::vector<AtlasImage> loadAtlasImages(const std::string &directory, unsigned threads = 0);
+
+class TextureAtlas
+{
+    // packs many small images into a few large RGBA pages with imstb_rectpack, so sprites that
+    // share a page share a texture and ImGui can merge their draw calls into one.
+    // this only does the CPU side, TextureCache uploads the pages.
+
+public:
+    // pack images into pages no larger than pageSize x pageSize. every image is surrounded by a
+    // copy of its edge pixels so linear filtering never samples a neighbour. images too big for
+    // a page are left out. returns the number of images packed.
+    int build(const std::vector<AtlasImage> &images, int pageSize = TEXTURE_ATLAS_PAGE_SIZE);
+
+    bool find(const std::string &name, AtlasRegion &region) const;
+
+    const std::vector<AtlasPage> &pages() const { return _pages; }
+    const std::unordered_map<std::string, AtlasRegion> &regions() const { return _regions; }
+
+    // drop the page pixels once they have been uploaded, the regions stay
+    void releasePixels();
+    void clear();
+
+private:
+    std::vector<AtlasPage> _pages;
+    std::unordered_map<std::string, AtlasRegion> _regions;
+};
@@ -0,0 +1,304 @@
+#include "TextureCache.h"
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include <iostream>
+#include <filesystem>
+
+TextureCache &TextureCache::GetInstance()
+{
+    static TextureCache instance;
+    return instance;
+}
+
+bool TextureCache::acquire(const std::string &path, TextureRegion &region)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto atlasIt = _atlasRegions.find(path);
+    if (atlasIt != _atlasRegions.end()) {
+        const AtlasRegion &atlasRegion = atlasIt->second;
+        region.texture = _atlasTextures[atlasRegion.page];
+        region.size = atlasRegion.size;
+        region.uv0 = atlasRegion.uv0;
+        region.uv1 = atlasRegion.uv1;
+        region.page = atlasRegion.page;
+        return true;
+    }
+
+    auto it = _entries.find(path);
+    if (it != _entries.end()) {
+        it->second.refCount++;
+        region = TextureRegion();
+        region.texture = it->second.texture;
+        region.size = it->second.size;
+        return true;
+    }
+
+    // Load from file
+    int image_width = 0;
+    int image_height = 0;
+    std::filesystem::path resourcePath = std::filesystem::path("resources") / path;
+    std::string newFilename = resourcePath.string();
+    unsigned char* image_data = stbi_load(newFilename.c_str(), &image_width, &image_height, NULL, 4);
+    if (image_data == NULL) {
+        std::cout << "Failed to load texture: " << newFilename << std::endl;
+        return false;
+    }
+    ImTextureID loaded = _loadTextureFromMemory(image_data, image_width, image_height);
+    stbi_image_free(image_data);
+    if (loaded == 0) {
+        return false;
+    }
+
+    Entry entry;
+    entry.texture = loaded;
+    entry.size = ImVec2((float)image_width, (float)image_height);
+    entry.refCount = 1;
+    _entries[path] = entry;
+
+    region = TextureRegion();
+    region.texture = entry.texture;
+    region.size = entry.size;
+    return true;
+}
+
+void TextureCache::release(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // atlas images aren't counted, the pages live until releaseAtlas()
+    auto it = _entries.find(path);
+    if (it == _entries.end()) {
+        return;
+    }
+    if (--it->second.refCount <= 0) {
+        _destroyTexture(it->second.texture);
+        _entries.erase(it);
+    }
+}
+
+// a bundle is only used while no PNG next to it has been edited since it was baked
+static bool bundleIsCurrent(const std::string &bundleFile, const std::string &directory)
+{
+    std::error_code error;
+    auto bundleTime = std::filesystem::last_write_time(bundleFile, error);
+    if (error) {
+        return false;
+    }
+    for (const auto &file : std::filesystem::directory_iterator(directory, error)) {
+        if (file.path().extension() == ".png" && file.last_write_time(error) > bundleTime) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::unique_ptr<TextureCache::PreparedAtlas> TextureCache::_prepareAtlas(const std::string &directory)
+{
+    auto prepared = std::make_unique<PreparedAtlas>();
+    std::string bundleFile = directory + ".bundle";
+    if (bundleIsCurrent(bundleFile, directory) && prepared->bundle.open(bundleFile)) {
+        // pre-decoded and pre-packed, the pages go straight from the mapping to the GPU
+        prepared->fromBundle = true;
+        return prepared;
+    }
+
+    // development fallback, anything too big for a page keeps loading as a texture of its own
+    prepared->atlas.build(loadAtlasImages(directory), TEXTURE_ATLAS_PAGE_SIZE);
+    return prepared;
+}
+
+void TextureCache::preloadAtlas(const std::string &directory)
+{
+    _preparing = std::async(std::launch::async, &TextureCache::_prepareAtlas, directory);
+}
+
+int TextureCache::finishAtlas()
+{
+    if (!_preparing.valid()) {
+        return 0;
+    }
+    std::unique_ptr<PreparedAtlas> prepared = _preparing.get();
+
+    std::vector<AssetBundlePage> pages;
+    if (prepared->fromBundle) {
+        pages = prepared->bundle.pages();
+    } else {
+        for (const AtlasPage &page : prepared->atlas.pages()) {
+            AssetBundlePage upload;
+            upload.width = page.width;
+            upload.height = page.height;
+            upload.pixels = page.pixels.data();
+            pages.push_back(upload);
+        }
+    }
+    const std::unordered_map<std::string, AtlasRegion> &regions =
+        prepared->fromBundle ? prepared->bundle.regions() : prepared->atlas.regions();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_uploadAtlas(pages, regions)) {
+        return 0;
+    }
+    _atlasFromBundle = prepared->fromBundle;
+    return (int)_atlasRegions.size();
+}
+
+int TextureCache::buildAtlas(const std::string &directory)
+{
+    preloadAtlas(directory);
+    return finishAtlas();
+}
+
+bool TextureCache::_uploadAtlas(const std::vector<AssetBundlePage> &pages,
+                                const std::unordered_map<std::string, AtlasRegion> &regions)
+{
+    _destroyAtlas();
+    for (const AssetBundlePage &page : pages) {
+        ImTextureID texture = _loadTextureFromMemory(page.pixels, page.width, page.height);
+        if (texture == 0) {
+            _destroyAtlas();
+            return false;
+        }
+        _atlasTextures.push_back(texture);
+    }
+    _atlasRegions = regions;
+    return true;
+}
+
+void TextureCache::_destroyAtlas()
+{
+    for (ImTextureID texture : _atlasTextures) {
+        _destroyTexture(texture);
+    }
+    _atlasTextures.clear();
+    _atlasRegions.clear();
+    _atlasFromBundle = false;
+}
+
+void TextureCache::releaseAtlas()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _destroyAtlas();
+}
+
+size_t TextureCache::atlasPageCount()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _atlasTextures.size();
+}
+
+bool TextureCache::atlasFromBundle()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _atlasFromBundle;
+}
+
+size_t TextureCache::size()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entries.size();
+}
+
+#if defined(SPRITE_HEADLESS)
+
+// headless builds (bench) decode images as usual but never touch a GPU
+ImTextureID TextureCache::_loadTextureFromMemory(const unsigned char *image_data, int image_width, int image_height)
+{
+    return (ImTextureID)1;
+}
+
+void TextureCache::_destroyTexture(ImTextureID texture)
+{
+}
+
+#elif defined(__APPLE__)
+#include "../imgui/imgui_impl_opengl3_loader.h"
+
+ImTextureID TextureCache::_loadTextureFromMemory(const unsigned char *image_data, int image_width, int image_height)
+{
+    // Create a OpenGL texture identifier
+    GLuint image_texture;
+    glGenTextures(1, &image_texture);
+    glBindTexture(GL_TEXTURE_2D, image_texture);
+
+    // Setup filtering parameters for display
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // Upload pixels into texture
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image_width, image_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image_data);
+
+    return static_cast<ImTextureID>(image_texture);
+}
+
+void TextureCache::_destroyTexture(ImTextureID texture)
+{
+    GLuint image_texture = (GLuint)texture;
+    glDeleteTextures(1, &image_texture);
+}
+
+#else
+
+// DirectX
+#include <stdio.h>
+#include <d3d11.h>
+#include <d3dcompiler.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "d3dcompiler") // Automatically link with d3dcompiler.lib as we are using D3DCompile() below.
+#endif
+
+ImTextureID TextureCache::_loadTextureFromMemory(const unsigned char *image_data, int image_width, int image_height)
+{
+    // Create texture
+    D3D11_TEXTURE2D_DESC desc;
+    ZeroMemory(&desc, sizeof(desc));
+    desc.Width = image_width;
+    desc.Height = image_height;
+    desc.MipLevels = 1;
+    desc.ArraySize = 1;
+    desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    desc.CPUAccessFlags = 0;
+
+    ID3D11Texture2D *pTexture = NULL;
+    D3D11_SUBRESOURCE_DATA subResource;
+    subResource.pSysMem = image_data;
+    subResource.SysMemPitch = desc.Width * 4;
+    subResource.SysMemSlicePitch = 0;
+
+    // You need to have a valid ID3D11Device* available as g_pd3dDevice
+    extern ID3D11Device* g_pd3dDevice; // Add this line if g_pd3dDevice is defined elsewhere
+
+    HRESULT hr = g_pd3dDevice->CreateTexture2D(&desc, &subResource, &pTexture);
+    if (FAILED(hr) || !pTexture) {
+        return 0;
+    }
+
+    // Create texture view
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+    ZeroMemory(&srvDesc, sizeof(srvDesc));
+    srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MipLevels = desc.MipLevels;
+    srvDesc.Texture2D.MostDetailedMip = 0;
+
+    ID3D11ShaderResourceView* shaderResourceView = nullptr;
+    hr = g_pd3dDevice->CreateShaderResourceView(pTexture, &srvDesc, &shaderResourceView);
+    pTexture->Release();
+
+    if (FAILED(hr) || !shaderResourceView) {
+
+        return 0;
+    }
+    return reinterpret_cast<ImTextureID>(shaderResourceView);
+}
+void TextureCache::_destroyTexture(ImTextureID texture)
+{
+    ID3D11ShaderResourceView* shaderResourceView = reinterpret_cast<ID3D11ShaderResourceView*>(texture);
+    if (shaderResourceView) {
+        shaderResourceView->Release();
+    }
+}
+#endif
@@ -0,0 +1,96 @@
+#pragma once
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../imgui/imgui.h"
+#include "AssetBundle.h"
+#include "TextureAtlas.h"
+
+// what a sprite draws: a texture and the part of it holding the image
+struct TextureRegion
+{
+    ImTextureID texture = 0;
+    ImVec2 size;
+    ImVec2 uv0 = ImVec2(0, 0);
+    ImVec2 uv1 = ImVec2(1, 1);
+    // atlas page the image is on, -1 for a texture of its own
+    int page = -1;
+};
+
+class TextureCache
+{
+    // process-wide cache of GPU textures keyed by resource path
+    // the first sprite to ask for an image decodes and uploads it, every later one shares the same
+    // texture. textures are reference counted and freed when the last sprite lets go of them.
+    // once buildAtlas() has run, images under resources/ come out of the shared atlas pages
+    // instead, which stay resident until releaseAtlas(). the atlas comes prebaked from
+    // resources.bundle when there is an up to date one, else it is packed from the PNGs.
+
+public:
+    static TextureCache &GetInstance();
+
+    TextureCache(const TextureCache &) = delete;
+    TextureCache &operator=(const TextureCache &) = delete;
+
+    // get the texture for a path under resources/, loading it on first use
+    // every successful acquire of a texture of its own (page -1) must be paired with a release
+    bool acquire(const std::string &path, TextureRegion &region);
+    // drop one reference, the GPU texture goes away with the last one
+    void release(const std::string &path);
+
+    // upload the atlas pages for the images in directory, from directory + ".bundle" if no PNG
+    // is newer than it, else by decoding and packing the PNGs. needs the graphics backend to be
+    // up. returns the number of images in the atlas. same as preloadAtlas + finishAtlas.
+    int buildAtlas(const std::string &directory = "resources");
+    // start reading or decoding the atlas on background threads and return right away, the
+    // caller can get on with other startup work meanwhile
+    void preloadAtlas(const std::string &directory = "resources");
+    // wait for preloadAtlas to finish and upload the pages on this (the render) thread.
+    // returns the number of images in the atlas, 0 if nothing was preloaded.
+    int finishAtlas();
+    // free the atlas pages, sprites still pointing into them must be reloaded
+    void releaseAtlas();
+    size_t atlasPageCount();
+    // the current atlas was loaded from a prebaked bundle
+    bool atlasFromBundle();
+
+    // number of distinct textures currently resident, atlas pages not included
+    size_t size();
+
+private:
+    TextureCache() {}
+
+    struct Entry
+    {
+        ImTextureID texture;
+        ImVec2 size;
+        int refCount;
+    };
+
+    std::unordered_map<std::string, Entry> _entries;
+    std::unordered_map<std::string, AtlasRegion> _atlasRegions;
+    std::vector<ImTextureID> _atlasTextures;
+    bool _atlasFromBundle = false;
+    std::mutex _mutex;
+
+    // private platform specific texture upload and release
+    ImTextureID _loadTextureFromMemory(const unsigned char *image_data, int image_width, int image_height);
+    void _destroyTexture(ImTextureID texture);
+    // CPU side of an atlas, waiting for its pages to be uploaded
+    struct PreparedAtlas
+    {
+        AssetBundle bundle;
+        TextureAtlas atlas;
+        bool fromBundle = false;
+    };
+    static std::unique_ptr<PreparedAtlas> _prepareAtlas(const std::string &directory);
+    std::future<std::unique_ptr<PreparedAtlas>> _preparing;
+
+    // replace the atlas with these pages and regions, must hold _mutex
+    bool _uploadAtlas(const std::vector<AssetBundlePage> &pages,
+                      const std::unordered_map<std::string, AtlasRegion> &regions);
+    void _destroyAtlas();
+};
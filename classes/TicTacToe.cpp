@@ -1,4 +1,7 @@
 #include "TicTacToe.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cstdint>
 
 // -----------------------------------------------------------------------------
 // TicTacToe.cpp
@@ -28,7 +31,16 @@
 const int AI_PLAYER = 1;    // index of the AI player (O)
 const int HUMAN_PLAYER = 0; // index of the human player (X)
 
-TicTacToe::TicTacToe() {}
+// transposition table slots, comfortably more than the number of distinct
+// positions once symmetries are folded together
+const size_t AI_TABLE_ENTRIES = 1 << 13;
+
+TicTacToe::TicTacToe()
+    : _searchMode(AISearchMode::PerfectTable), _lastSearchNodes(0),
+      _transpositionTable(AI_TABLE_ENTRIES), _asyncAI(false),
+      _aiJobActive(false), _aiJobId(0) {
+  resetLineCounts();
+}
 
 TicTacToe::~TicTacToe() {}
 
@@ -59,6 +71,7 @@ void TicTacToe::setUpBoard() {
       _grid[y][x].setGameTag(0); // 0 for empty
     }
   }
+  resetLineCounts();
 
   startGame();
 }
@@ -81,14 +94,14 @@ bool TicTacToe::actionForEmptyHolder(BitHolder *holder) {
     return false;
   }
 
-  Bit *bit = PieceForPlayer(p->playerNumber());
-  if (bit) {
-    bit->setPosition(holder->getPosition());
-    holder->setBit(bit);
-    return true;
-  }
+  int index = (int)(static_cast<Square *>(holder) - &_grid[0][0]);
+  if (index < 0 || index >= 9)
+    return false;
 
-  return false;
+  placePieceAt(index, p->playerNumber());
+  recordMoveEvent(ClassGame::GameEventId::HUMAN_MOVE, p->playerNumber(), index,
+                  0);
+  return true;
 }
 
 bool TicTacToe::canBitMoveFrom(Bit *bit, BitHolder *src) { return false; }
@@ -101,11 +114,92 @@ bool TicTacToe::canBitMoveFromTo(Bit *bit, BitHolder *src, BitHolder *dst) {
 // free all the memory used by the game on the heap
 //
 void TicTacToe::stopGame() {
+  cancelAI();
   for (int y = 0; y < 3; y++) {
     for (int x = 0; x < 3; x++) {
       _grid[y][x].destroyBit();
     }
   }
+  resetLineCounts();
+}
+
+//
+// put a new piece on the board and update the counters for the lines
+// through that square. only these lines can have just been completed.
+//
+void TicTacToe::placePieceAt(int index, int playerNumber) {
+  int y = index / 3;
+  int x = index % 3;
+  Bit *bit = PieceForPlayer(playerNumber);
+  bit->setPosition(_grid[y][x].getPosition());
+  _grid[y][x].setBit(bit);
+
+  _board.place(index, playerNumber);
+  _filledCells++;
+  const SquareLines &lines = kLinesThroughSquares.squares[index];
+  for (int i = 0; i < lines.count; i++) {
+    if (++_lineCounts[lines.lines[i]][playerNumber] == 3 &&
+        _winningPlayer < 0) {
+      _winningPlayer = playerNumber;
+    }
+  }
+}
+
+//
+// take a piece off the board, if that broke the winning line look at the
+// eight line counters again for any other
+//
+void TicTacToe::removePieceAt(int index) {
+  int owner = _board.ownerAt(index);
+  _grid[index / 3][index % 3].destroyBit();
+  if (owner < 0)
+    return;
+
+  _board.clear(index, owner);
+  _filledCells--;
+  const SquareLines &lines = kLinesThroughSquares.squares[index];
+  for (int i = 0; i < lines.count; i++) {
+    _lineCounts[lines.lines[i]][owner]--;
+  }
+  if (_winningPlayer >= 0) {
+    _winningPlayer = -1;
+    for (int line = 0; line < 8 && _winningPlayer < 0; line++) {
+      for (int player = 0; player < 2; player++) {
+        if (_lineCounts[line][player] == 3) {
+          _winningPlayer = player;
+          break;
+        }
+      }
+    }
+  }
+}
+
+void TicTacToe::resetLineCounts() {
+  _board = TicTacToeBoard();
+  for (int line = 0; line < 8; line++) {
+    _lineCounts[line][0] = 0;
+    _lineCounts[line][1] = 0;
+  }
+  _filledCells = 0;
+  _winningPlayer = -1;
+}
+
+void TicTacToe::recordMoveEvent(ClassGame::GameEventId id, int playerNumber,
+                                int move, uint64_t aiMicros) {
+  ClassGame::EventLog &eventLog = ClassGame::EventLog::GetInstance();
+  if (!eventLog.IsOpen()) {
+    return;
+  }
+  ClassGame::GameEventRecord record;
+  record.id = id;
+  record.player = (int8_t)playerNumber;
+  record.move = (int8_t)move;
+  record.board = _board.key();
+  if (id == ClassGame::GameEventId::AI_MOVE) {
+    record.aiNodes = (uint32_t)std::min<uint64_t>(_lastSearchNodes, UINT32_MAX);
+    record.aiMicros = (uint32_t)std::min<uint64_t>(aiMicros, UINT32_MAX);
+  }
+  eventLog.Record(record);
 }
 
 //
@@ -122,32 +216,18 @@ Player *TicTacToe::ownerAt(int index) const {
   return nullptr;
 }
 
+//
+// both checks read the counters kept by placePieceAt/removePieceAt
+//
 Player *TicTacToe::checkForWinner() {
-  int wins[8][3] = {
-      {0, 1, 2}, {3, 4, 5}, {6, 7, 8}, // rows
-      {0, 3, 6}, {1, 4, 7}, {2, 5, 8}, // cols
-      {0, 4, 8}, {2, 4, 6}             // diagonals
-  };
-
-  for (int i = 0; i < 8; i++) {
-    Player *p0 = ownerAt(wins[i][0]);
-    Player *p1 = ownerAt(wins[i][1]);
-    Player *p2 = ownerAt(wins[i][2]);
-
-    if (p0 && p0 == p1 && p1 == p2) {
-      return p0;
-    }
+  if (_winningPlayer < 0) {
+    return nullptr;
   }
-  return nullptr;
+  return getPlayerAt(_winningPlayer);
 }
 
 bool TicTacToe::checkForDraw() {
-  for (int i = 0; i < 9; i++) {
-    if (ownerAt(i) == nullptr) {
-      return false;
-    }
-  }
-  return true;
+  return _filledCells == 9 && _winningPlayer < 0;
 }
 
 //
@@ -179,126 +259,119 @@ std::string TicTacToe::stateString() const {
 //
 void TicTacToe::setStateString(const std::string &s) {
   for (int i = 0; i < 9 && i < s.length(); i++) {
-    int y = i / 3;
-    int x = i % 3;
     int playerNum = s[i] - '0';
 
-    _grid[y][x].destroyBit();
+    removePieceAt(i);
 
     if (playerNum > 0) {
-      Bit *bit = PieceForPlayer(playerNum - 1);
-      bit->setPosition(_grid[y][x].getPosition());
-      _grid[y][x].setBit(bit);
+      placePieceAt(i, playerNum - 1);
     }
   }
 }
 
 //
-// Helper: check winner on a simulated board (0=empty, 1=player0, 2=player1)
+// this is the function that will be called by the AI
 //
-static int checkWinnerOnBoard(int board[9]) {
-  int wins[8][3] = {
-      {0, 1, 2}, {3, 4, 5}, {6, 7, 8}, // rows
-      {0, 3, 6}, {1, 4, 7}, {2, 5, 8}, // cols
-      {0, 4, 8}, {2, 4, 6}             // diagonals
-  };
-  for (int i = 0; i < 8; i++) {
-    int a = board[wins[i][0]];
-    int b = board[wins[i][1]];
-    int c = board[wins[i][2]];
-    if (a != 0 && a == b && b == c) {
-      return a; // Return which player won (1 or 2)
-    }
+void TicTacToe::updateAI() {
+  TRACE_SCOPE("TicTacToe::updateAI");
+  if (_winningPlayer >= 0 || _filledCells == 9) {
+    return;
+  }
+
+  int aiPlayer = getCurrentPlayer()->playerNumber();
+  auto start = std::chrono::steady_clock::now();
+  AISearchResult result =
+      searchBestMove(_board, aiPlayer, _searchMode, &_transpositionTable,
+                     nullptr, _gameOptions.AIMAXDepth);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  _gameOptions.AIDepthSearches++;
+  _lastSearchNodes = result.nodes;
+
+  recordAISearchMetrics(
+      (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+          .count(),
+      result.nodes);
+  int bestMove = result.move;
+
+  // Make best move on actual game board
+  if (bestMove != -1) {
+    placePieceAt(bestMove, aiPlayer);
+    recordMoveEvent(
+        ClassGame::GameEventId::AI_MOVE, aiPlayer, bestMove,
+        (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed)
+            .count());
+    endTurn();
   }
-  return 0; // No winner
 }
 
 //
-// Helper: check if board is full (draw if no winner)
+// background AI
 //
-static bool isBoardFull(int board[9]) {
-  for (int i = 0; i < 9; i++) {
-    if (board[i] == 0)
-      return false;
+void TicTacToe::setAsyncAI(bool enable) {
+  if (!enable) {
+    cancelAI();
+  } else if (!_aiWorker) {
+    _aiWorker = std::make_unique<AIWorker>();
   }
-  return true;
+  _asyncAI = enable;
 }
 
 //
-// Negamax on simulated board - fast, no texture loading
-// currentPlayer: 1 or 2 (matching board values)
+// post a snapshot of the live position, nothing on the board is shared with
+// the worker thread
 //
-static int negamaxBoard(int board[9], int currentPlayer) {
-  int winner = checkWinnerOnBoard(board);
-  if (winner != 0) {
-    return (winner == currentPlayer) ? 10 : -10;
+bool TicTacToe::requestAIMove() {
+  if (!_asyncAI || !_aiWorker || _aiJobActive) {
+    return false;
   }
-  if (isBoardFull(board)) {
-    return 0;
+  if (_winningPlayer >= 0 || _filledCells == 9) {
+    return false;
   }
 
-  int bestScore = -100;
-  int opponent = (currentPlayer == 1) ? 2 : 1;
-
-  for (int i = 0; i < 9; i++) {
-    if (board[i] == 0) {
-      board[i] = currentPlayer;
-      int score = -negamaxBoard(board, opponent);
-      board[i] = 0;
-      if (score > bestScore) {
-        bestScore = score;
-      }
-    }
-  }
-  return bestScore;
+  _aiJobBoard = _board;
+  _aiJobStart = std::chrono::steady_clock::now();
+  _aiJobId = _aiWorker->post(_board, getCurrentPlayer()->playerNumber(),
+                             _searchMode, _gameOptions.AIMAXDepth);
+  _gameOptions.AIDepthSearches++;
+  _aiJobActive = true;
+  return true;
 }
 
 //
-// this is the function that will be called by the AI
+// play the worker's move if it is ready and still matches the board
 //
-void TicTacToe::updateAI() {
-  if (checkForWinner() || checkForDraw()) {
-    return;
+TicTacToe::AIMoveStatus TicTacToe::applyAIMove() {
+  if (!_aiJobActive) {
+    return AIMoveStatus::None;
   }
 
-  // Build a simple board representation from current state
-  // 0 = empty, 1 = player 0 (X), 2 = player 1 (O)
-  int board[9];
-  for (int i = 0; i < 9; i++) {
-    Player *owner = ownerAt(i);
-    if (owner == nullptr) {
-      board[i] = 0;
-    } else {
-      board[i] = owner->playerNumber() + 1; // 1 for player 0, 2 for player 1
-    }
+  AISearchResult result;
+  if (!_aiWorker->poll(_aiJobId, result)) {
+    return AIMoveStatus::None;
   }
+  _aiJobActive = false;
 
-  int bestMove = -1;
-  int bestScore = -100;
-  int aiPlayer = getCurrentPlayer()->playerNumber();
-  int aiBoardVal = aiPlayer + 1; // 1 or 2
-  int opponentBoardVal = (aiBoardVal == 1) ? 2 : 1;
-
-  for (int i = 0; i < 9; i++) {
-    if (board[i] == 0) {
-      board[i] = aiBoardVal;
-      int score = -negamaxBoard(board, opponentBoardVal);
-      board[i] = 0;
-
-      if (score > bestScore) {
-        bestScore = score;
-        bestMove = i;
-      }
-    }
+  if (!(_board == _aiJobBoard) || result.move < 0 ||
+      !_board.isEmpty(result.move)) {
+    return AIMoveStatus::Discarded;
   }
 
-  // Make best move on actual game board
-  if (bestMove != -1) {
-    int y = bestMove / 3;
-    int x = bestMove % 3;
-    Bit *bit = PieceForPlayer(aiPlayer);
-    bit->setPosition(_grid[y][x].getPosition());
-    _grid[y][x].setBit(bit);
-    endTurn();
+  _lastSearchNodes = result.nodes;
+  int aiPlayer = getCurrentPlayer()->playerNumber();
+  placePieceAt(result.move, aiPlayer);
+  // time from the request to the move being played
+  auto waited = std::chrono::steady_clock::now() - _aiJobStart;
+  recordMoveEvent(
+      ClassGame::GameEventId::AI_MOVE, aiPlayer, result.move,
+      (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(waited)
+          .count());
+  endTurn();
+  return AIMoveStatus::Played;
+}
+
+void TicTacToe::cancelAI() {
+  if (_aiWorker) {
+    _aiWorker->cancel();
   }
+  _aiJobActive = false;
 }
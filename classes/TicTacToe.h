@@ -1,6 +1,12 @@
 #pragma once
+#include "AIWorker.h"
+#include "EventLog.h"
 #include "Game.h"
 #include "Square.h"
+#include "TicTacToeAI.h"
+#include "TicTacToeBoard.h"
+#include <chrono>
+#include <memory>
 
 //
 // the classic game of tic tac toe
@@ -33,9 +39,59 @@ public:
     return _grid[y][x];
   }
 
+  // which search updateAI runs, and how many positions the last one visited
+  void setSearchMode(AISearchMode mode) { _searchMode = mode; }
+  AISearchMode getSearchMode() const { return _searchMode; }
+  uint64_t getLastSearchNodes() const { return _lastSearchNodes; }
+  // live position, e.g. for the event log (TicTacToeBoard::key())
+  const TicTacToeBoard &getBoard() const { return _board; }
+  // kept for the whole session so later moves reuse earlier searches
+  const TranspositionTable &getTranspositionTable() const {
+    return _transpositionTable;
+  }
+
+  // background AI: requestAIMove posts the current position to a worker
+  // thread and returns straight away (false if nothing was posted),
+  // applyAIMove plays the answer once it has arrived (call it from the main
+  // thread, at the start of a frame). an answer that no longer fits the
+  // board is Discarded and the caller should request a new one.
+  enum class AIMoveStatus { None, Played, Discarded };
+  void setAsyncAI(bool enable);
+  bool isAsyncAI() const { return _asyncAI; }
+  bool requestAIMove();
+  AIMoveStatus applyAIMove();
+  bool isAIThinking() const { return _aiJobActive; }
+  void cancelAI();
+
 private:
   Bit *PieceForPlayer(const int playerNumber);
   Player *ownerAt(int index) const;
+  // every piece goes on and comes off through these so the line counters
+  // below stay in step with the grid
+  void placePieceAt(int index, int playerNumber);
+  void removePieceAt(int index);
+  void resetLineCounts();
+  // append a HUMAN_MOVE / AI_MOVE record to the binary event log
+  void recordMoveEvent(ClassGame::GameEventId id, int playerNumber, int move,
+                       uint64_t aiMicros);
 
   Square _grid[3][3];
+  // live position, kept up to date as pieces are placed and removed
+  TicTacToeBoard _board;
+  // pieces each player has on every kWinMasks line
+  int _lineCounts[8][2];
+  int _filledCells;
+  // player number with three in a row, or -1
+  int _winningPlayer;
+  AISearchMode _searchMode;
+  uint64_t _lastSearchNodes;
+  TranspositionTable _transpositionTable;
+
+  // background search state, see requestAIMove
+  std::unique_ptr<AIWorker> _aiWorker;
+  bool _asyncAI;
+  bool _aiJobActive;
+  uint64_t _aiJobId;
+  TicTacToeBoard _aiJobBoard;
+  std::chrono::steady_clock::time_point _aiJobStart;
 };
@@ -0,0 +1,215 @@
+#include "TicTacToeAI.h"
+#include "TicTacToePerfectPlay.h"
+
+//
+// Negamax on simulated board - fast, no texture loading
+// currentPlayer: 0 or 1 (matching Player::playerNumber)
+//
+int negamaxBoard(TicTacToeBoard &board, int currentPlayer, uint64_t &nodes) {
+  nodes++;
+  int winner = checkWinnerOnBoard(board);
+  if (winner >= 0) {
+    return (winner == currentPlayer) ? 10 : -10;
+  }
+  if (isBoardFull(board)) {
+    return 0;
+  }
+
+  int bestScore = -100;
+  int opponent = 1 - currentPlayer;
+
+  for (int i = 0; i < 9; i++) {
+    if (board.isEmpty(i)) {
+      board.place(i, currentPlayer);
+      int score = -negamaxBoard(board, opponent, nodes);
+      board.clear(i, currentPlayer);
+      if (score > bestScore) {
+        bestScore = score;
+      }
+    }
+  }
+  return bestScore;
+}
+
+//
+// Alpha-beta on simulated board
+// only the player who just moved can have completed a line, so that is the
+// only win we need to test for
+//
+int alphaBetaBoard(TicTacToeBoard &board, int currentPlayer, int ply,
+                   int alpha, int beta, uint64_t &nodes, int maxDepth) {
+  nodes++;
+  int opponent = 1 - currentPlayer;
+  if (hasWinOnBoard(board, opponent)) {
+    return -(kAIWinScore - ply);
+  }
+  if (isBoardFull(board) || (maxDepth > 0 && ply >= maxDepth)) {
+    return 0;
+  }
+
+  int bestScore = -kAIWinScore - 1;
+  for (int i : kAIMoveOrder) {
+    if (!board.isEmpty(i)) {
+      continue;
+    }
+    board.place(i, currentPlayer);
+    int score = -alphaBetaBoard(board, opponent, ply + 1, -beta, -alpha,
+                                nodes, maxDepth);
+    board.clear(i, currentPlayer);
+
+    if (score > bestScore) {
+      bestScore = score;
+    }
+    if (bestScore > alpha) {
+      alpha = bestScore;
+    }
+    if (alpha >= beta) {
+      break; // the opponent will never allow this line
+    }
+  }
+  return bestScore;
+}
+
+//
+// table scores are stored relative to the node they were found at, so a
+// "win in 2" means the same thing whatever the root was
+//
+static int scoreToTable(int score, int ply) {
+  if (score > 0)
+    return score + ply;
+  if (score < 0)
+    return score - ply;
+  return 0;
+}
+
+static int scoreFromTable(int score, int ply) {
+  if (score > 0)
+    return score - ply;
+  if (score < 0)
+    return score + ply;
+  return 0;
+}
+
+//
+// Alpha-beta with a transposition table
+//
+int alphaBetaTTBoard(TicTacToeBoard &board, int currentPlayer, int ply,
+                     int alpha, int beta, TranspositionTable &table,
+                     uint64_t &nodes) {
+  nodes++;
+  int opponent = 1 - currentPlayer;
+  if (hasWinOnBoard(board, opponent)) {
+    return -(kAIWinScore - ply);
+  }
+  if (isBoardFull(board)) {
+    return 0;
+  }
+
+  int alphaOrig = alpha;
+  int tableScore = 0;
+  TTBound tableBound = TTBound::None;
+  int tableMove = -1;
+  if (table.probe(board, currentPlayer, tableScore, tableBound, tableMove)) {
+    tableScore = scoreFromTable(tableScore, ply);
+    if (tableBound == TTBound::Exact) {
+      return tableScore;
+    }
+    if (tableBound == TTBound::Lower && tableScore > alpha) {
+      alpha = tableScore;
+    } else if (tableBound == TTBound::Upper && tableScore < beta) {
+      beta = tableScore;
+    }
+    if (alpha >= beta) {
+      return tableScore;
+    }
+  }
+
+  int bestScore = -kAIWinScore - 1;
+  int bestMove = -1;
+  // try the table move first, then the usual ordering
+  for (int n = -1; n < 9; n++) {
+    int i = (n < 0) ? tableMove : kAIMoveOrder[n];
+    if (i < 0 || (n >= 0 && i == tableMove) || !board.isEmpty(i)) {
+      continue;
+    }
+    board.place(i, currentPlayer);
+    int score = -alphaBetaTTBoard(board, opponent, ply + 1, -beta, -alpha,
+                                  table, nodes);
+    board.clear(i, currentPlayer);
+
+    if (score > bestScore) {
+      bestScore = score;
+      bestMove = i;
+    }
+    if (bestScore > alpha) {
+      alpha = bestScore;
+    }
+    if (alpha >= beta) {
+      break;
+    }
+  }
+
+  TTBound bound = TTBound::Exact;
+  if (bestScore <= alphaOrig) {
+    bound = TTBound::Upper;
+  } else if (bestScore >= beta) {
+    bound = TTBound::Lower;
+  }
+  table.store(board, currentPlayer, scoreToTable(bestScore, ply), bound,
+              bestMove);
+  return bestScore;
+}
+
+AISearchResult searchBestMove(const TicTacToeBoard &board, int player,
+                              AISearchMode mode, TranspositionTable *table,
+                              const std::atomic<bool> *cancel,
+                              int maxDepth) {
+  AISearchResult result;
+  if (maxDepth > 0) {
+    mode = AISearchMode::AlphaBeta;
+  }
+  if (mode == AISearchMode::PerfectTable && sideToMove(board) == player) {
+    result.move = perfectPlayMove(board);
+    result.score = perfectPlayScore(board);
+    result.nodes = 1;
+    if (result.move >= 0) {
+      return result;
+    }
+  }
+  result.score = -kAIWinScore - 1;
+
+  TicTacToeBoard scratch = board;
+  int opponent = 1 - player;
+  int alpha = -kAIWinScore - 1;
+  int beta = kAIWinScore + 1;
+
+  for (int i : kAIMoveOrder) {
+    if (!scratch.isEmpty(i)) {
+      continue;
+    }
+    if (cancel && cancel->load(std::memory_order_relaxed)) {
+      break;
+    }
+    scratch.place(i, player);
+    int score;
+    if (mode == AISearchMode::AlphaBetaTT && table) {
+      score = -alphaBetaTTBoard(scratch, opponent, 1, -beta, -alpha, *table,
+                                result.nodes);
+    } else if (mode != AISearchMode::Negamax) {
+      score = -alphaBetaBoard(scratch, opponent, 1, -beta, -alpha,
+                              result.nodes, maxDepth);
+    } else {
+      score = -negamaxBoard(scratch, opponent, result.nodes);
+    }
+    scratch.clear(i, player);
+
+    if (score > result.score) {
+      result.score = score;
+      result.move = i;
+    }
+    if (mode != AISearchMode::Negamax && score > alpha) {
+      alpha = score;
+    }
+  }
+  return result;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "TicTacToeBoard.h"
+#include "TranspositionTable.h"
+#include <atomic>
+#include <cstdint>
+
+//
+// the tic-tac-toe AI search, kept free of sprites and ImGui so it can run
+// anywhere a TicTacToeBoard can
+//
+
+// which search updateAI runs
+enum class AISearchMode {
+  Negamax,     // plain full-width negamax, the reference implementation
+  AlphaBeta,   // alpha-beta with center/corner/edge move ordering
+  AlphaBetaTT, // alpha-beta backed by a symmetry-aware transposition table
+  PerfectTable // constant-time lookup in the compile-time solved table
+};
+
+// result of a root search
+struct AISearchResult {
+  int move = -1;      // square index to play, -1 if there is no legal move
+  int score = 0;      // score from the point of view of the side to move
+  uint64_t nodes = 0; // positions visited
+};
+
+// squares in the order alpha-beta tries them: center, corners, edges
+constexpr int kAIMoveOrder[9] = {4, 0, 2, 6, 8, 1, 3, 5, 7};
+
+// score for a win found at the root, reduced by one for every ply it takes
+constexpr int kAIWinScore = 100;
+
+// full-width negamax, +-10 for a win/loss, 0 for a draw
+int negamaxBoard(TicTacToeBoard &board, int currentPlayer, uint64_t &nodes);
+
+// alpha-beta negamax with depth-adjusted scores (prefer faster wins, slower
+// losses). ply is the distance from the root position. with maxDepth > 0
+// positions that many plies down are scored as a draw.
+int alphaBetaBoard(TicTacToeBoard &board, int currentPlayer, int ply,
+                   int alpha, int beta, uint64_t &nodes, int maxDepth = 0);
+
+// alpha-beta that consults and fills a transposition table, trying the
+// table's best move first
+int alphaBetaTTBoard(TicTacToeBoard &board, int currentPlayer, int ply,
+                     int alpha, int beta, TranspositionTable &table,
+                     uint64_t &nodes);
+
+// pick the best move for player on board using the given search. table is
+// required for AISearchMode::AlphaBetaTT and ignored otherwise.
+// AISearchMode::PerfectTable falls back to alpha-beta when player is not the
+// side to move on board (only possible with a hand-edited state string).
+// if cancel is given it is checked between root moves and the search gives
+// up early once it is set; the result is then incomplete.
+// maxDepth (GameOptions::AIMAXDepth) limits how far ahead the AI looks, 0 is
+// no limit. a limited search always runs as plain alpha-beta since neither
+// the table nor the transposition table know about the horizon.
+AISearchResult searchBestMove(const TicTacToeBoard &board, int player,
+                              AISearchMode mode,
+                              TranspositionTable *table = nullptr,
+                              const std::atomic<bool> *cancel = nullptr,
+                              int maxDepth = 0);
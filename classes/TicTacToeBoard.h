@@ -0,0 +1,164 @@
+#pragma once
+#include <cstdint>
+
+//
+// compact tic-tac-toe position shared by the live game and the AI search
+//
+// one 9-bit mask per player, bit i is square i in row-major order
+// (0 = top left, 8 = bottom right). player numbers match
+// Player::playerNumber(), so 0 is X and 1 is O.
+//
+struct TicTacToeBoard {
+  static constexpr uint16_t kFullMask = 0x1FF;
+
+  // every three-in-a-row as a mask, built once instead of per call
+  static constexpr uint16_t kWinMasks[8] = {
+      0x007, 0x038, 0x1C0, // rows
+      0x049, 0x092, 0x124, // cols
+      0x111, 0x054         // diagonals
+  };
+
+  uint16_t masks[2] = {0, 0};
+
+  constexpr uint16_t occupied() const { return masks[0] | masks[1]; }
+  constexpr bool isEmpty(int index) const {
+    return (occupied() & (1u << index)) == 0;
+  }
+  constexpr void place(int index, int player) {
+    masks[player] |= (uint16_t)(1u << index);
+  }
+  constexpr void clear(int index, int player) {
+    masks[player] &= (uint16_t)~(1u << index);
+  }
+  // player number owning the square, or -1 if it is empty
+  constexpr int ownerAt(int index) const {
+    if (masks[0] & (1u << index))
+      return 0;
+    if (masks[1] & (1u << index))
+      return 1;
+    return -1;
+  }
+
+  // both masks packed into 18 bits, unique per position
+  constexpr uint32_t key() const {
+    return (uint32_t)masks[0] | ((uint32_t)masks[1] << 9);
+  }
+
+  constexpr bool operator==(const TicTacToeBoard &other) const {
+    return masks[0] == other.masks[0] && masks[1] == other.masks[1];
+  }
+};
+
+//
+// does this player have three in a row?
+//
+constexpr bool hasWinOnBoard(const TicTacToeBoard &board, int player) {
+  for (uint16_t win : TicTacToeBoard::kWinMasks) {
+    if ((board.masks[player] & win) == win)
+      return true;
+  }
+  return false;
+}
+
+//
+// winning player number on a board, or -1 if nobody has three in a row
+//
+constexpr int checkWinnerOnBoard(const TicTacToeBoard &board) {
+  if (hasWinOnBoard(board, 0))
+    return 0;
+  if (hasWinOnBoard(board, 1))
+    return 1;
+  return -1;
+}
+
+//
+// every square taken (draw if no winner)
+//
+constexpr bool isBoardFull(const TicTacToeBoard &board) {
+  return board.occupied() == TicTacToeBoard::kFullMask;
+}
+
+//
+// which of the kWinMasks lines pass through each square, so a move only
+// has to look at its own row, column and diagonals
+//
+struct SquareLines {
+  int count;
+  int lines[4];
+};
+
+struct LinesThroughSquares {
+  SquareLines squares[9];
+};
+
+constexpr LinesThroughSquares buildLinesThroughSquares() {
+  LinesThroughSquares result{};
+  for (int i = 0; i < 9; i++) {
+    for (int line = 0; line < 8; line++) {
+      if (TicTacToeBoard::kWinMasks[line] & (1u << i)) {
+        SquareLines &square = result.squares[i];
+        square.lines[square.count++] = line;
+      }
+    }
+  }
+  return result;
+}
+
+constexpr LinesThroughSquares kLinesThroughSquares =
+    buildLinesThroughSquares();
+
+//
+// the eight rotations/reflections of the board
+// kBoardSymmetries[s][i] is the square that square i lands on under s
+//
+constexpr int kBoardSymmetries[8][9] = {
+    {0, 1, 2, 3, 4, 5, 6, 7, 8}, // identity
+    {2, 5, 8, 1, 4, 7, 0, 3, 6}, // rotate 90
+    {8, 7, 6, 5, 4, 3, 2, 1, 0}, // rotate 180
+    {6, 3, 0, 7, 4, 1, 8, 5, 2}, // rotate 270
+    {2, 1, 0, 5, 4, 3, 8, 7, 6}, // mirror
+    {8, 5, 2, 7, 4, 1, 6, 3, 0}, // mirror + rotate 90
+    {6, 7, 8, 3, 4, 5, 0, 1, 2}, // mirror + rotate 180
+    {0, 3, 6, 1, 4, 7, 2, 5, 8}  // mirror + rotate 270
+};
+
+constexpr TicTacToeBoard transformBoard(const TicTacToeBoard &board,
+                                        int symmetry) {
+  TicTacToeBoard result;
+  for (int i = 0; i < 9; i++) {
+    int owner = board.ownerAt(i);
+    if (owner >= 0) {
+      result.place(kBoardSymmetries[symmetry][i], owner);
+    }
+  }
+  return result;
+}
+
+//
+// the symmetric copy of board with the smallest key, so mirrored and
+// rotated positions share one entry. symmetry receives the transform used.
+//
+constexpr TicTacToeBoard canonicalBoard(const TicTacToeBoard &board,
+                                        int &symmetry) {
+  TicTacToeBoard best = board;
+  symmetry = 0;
+  for (int s = 1; s < 8; s++) {
+    TicTacToeBoard candidate = transformBoard(board, s);
+    if (candidate.key() < best.key()) {
+      best = candidate;
+      symmetry = s;
+    }
+  }
+  return best;
+}
+
+//
+// map a square on the canonical board back to the original board
+//
+constexpr int squareFromCanonical(int square, int symmetry) {
+  for (int i = 0; i < 9; i++) {
+    if (kBoardSymmetries[symmetry][i] == square)
+      return i;
+  }
+  return -1;
+}
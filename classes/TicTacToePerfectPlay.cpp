@@ -0,0 +1,100 @@
+#include "TicTacToePerfectPlay.h"
+#include "TicTacToeAI.h"
+#include <cstdint>
+
+struct PerfectPlayTable {
+  int8_t move[kPerfectPlayPositions];
+  int8_t score[kPerfectPlayPositions];
+};
+
+// place value of each square in the base-3 index
+constexpr int kSquareWeight[9] = {6561, 2187, 729, 243, 81, 27, 9, 3, 1};
+
+//
+// retrograde solve of every index
+// a move only ever adds a non-zero digit, so a child's index is always larger
+// than its parent's. walking the indices downward therefore solves every
+// child before the positions that lead to it.
+//
+static constexpr PerfectPlayTable buildPerfectPlayTable() {
+  PerfectPlayTable table{};
+  for (int index = kPerfectPlayPositions - 1; index >= 0; index--) {
+    table.move[index] = -1;
+    table.score[index] = 0;
+
+    TicTacToeBoard board;
+    int rest = index;
+    for (int i = 8; i >= 0; i--) {
+      int digit = rest % 3;
+      rest /= 3;
+      if (digit != 0) {
+        board.place(i, digit - 1);
+      }
+    }
+
+    int xCount = std::popcount(board.masks[0]);
+    int oCount = std::popcount(board.masks[1]);
+    if (xCount != oCount && xCount != oCount + 1) {
+      continue; // can't come up in a real game
+    }
+
+    int player = sideToMove(board);
+    if (hasWinOnBoard(board, 1 - player)) {
+      table.score[index] = -10;
+      continue;
+    }
+    if (isBoardFull(board)) {
+      continue;
+    }
+
+    int bestScore = -100;
+    int bestMove = -1;
+    for (int i : kAIMoveOrder) {
+      if (!board.isEmpty(i)) {
+        continue;
+      }
+      int child = index + kSquareWeight[i] * (player + 1);
+      // one ply further from the end: wins shrink, losses grow toward 0
+      int score = -table.score[child];
+      if (score > 0) {
+        score--;
+      } else if (score < 0) {
+        score++;
+      }
+      if (score > bestScore) {
+        bestScore = score;
+        bestMove = i;
+      }
+    }
+    table.move[index] = (int8_t)bestMove;
+    table.score[index] = (int8_t)bestScore;
+  }
+  return table;
+}
+
+static constexpr PerfectPlayTable kPerfectPlayTable = buildPerfectPlayTable();
+
+// sanity checks on the solved table, evaluated by the compiler
+static_assert(kPerfectPlayTable.score[0] == 0, "tic-tac-toe is a draw");
+static_assert(kPerfectPlayTable.move[0] == 4, "X opens in the center");
+
+static bool isLegalBoard(const TicTacToeBoard &board) {
+  int xCount = std::popcount(board.masks[0]);
+  int oCount = std::popcount(board.masks[1]);
+  return (board.masks[0] & board.masks[1]) == 0 &&
+         (xCount == oCount || xCount == oCount + 1);
+}
+
+int perfectPlayMove(const TicTacToeBoard &board) {
+  if (!isLegalBoard(board)) {
+    return -1;
+  }
+  return kPerfectPlayTable.move[encodeBoardBase3(board)];
+}
+
+int perfectPlayScore(const TicTacToeBoard &board) {
+  if (!isLegalBoard(board)) {
+    return 0;
+  }
+  return kPerfectPlayTable.score[encodeBoardBase3(board)];
+}
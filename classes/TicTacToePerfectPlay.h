@@ -0,0 +1,36 @@
+#pragma once
+#include "TicTacToeBoard.h"
+#include <bit>
+
+//
+// perfect play for every tic-tac-toe position, solved at compile time
+//
+// positions are indexed by reading TicTacToe::stateString() as a base-3
+// number: square 0 is the most significant digit, 0 = empty, 1 = X, 2 = O.
+// the solver uses hasWinOnBoard/isBoardFull from TicTacToeBoard.h, the same
+// rules checkWinnerOnBoard is built on.
+//
+
+constexpr int kPerfectPlayPositions = 19683; // 3^9
+
+constexpr int encodeBoardBase3(const TicTacToeBoard &board) {
+  int index = 0;
+  for (int i = 0; i < 9; i++) {
+    index = index * 3 + (board.ownerAt(i) + 1);
+  }
+  return index;
+}
+
+// the player whose turn it is on a legal board, X moves first
+constexpr int sideToMove(const TicTacToeBoard &board) {
+  return std::popcount(board.masks[0]) > std::popcount(board.masks[1]) ? 1
+                                                                      : 0;
+}
+
+// best square for the side to move, or -1 if the game is over or the board
+// could not come up in a real game
+int perfectPlayMove(const TicTacToeBoard &board);
+
+// score for the side to move: 0 draw, positive win, negative loss. wins
+// closer to the root score higher (10 - plies to the end).
+int perfectPlayScore(const TicTacToeBoard &board);
@@ -0,0 +1,154 @@
+#include "Trace.h"
+#include <cstdio>
+#include <fstream>
+
+namespace ClassGame {
+
+static int64_t toNs(TraceClock::time_point time) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             time.time_since_epoch())
+      .count();
+}
+
+Tracer &Tracer::GetInstance() {
+  static Tracer instance;
+  return instance;
+}
+
+Tracer::ThreadBuffer &Tracer::GetThreadBuffer() {
+  // the registry keeps a reference too, so a thread's spans survive the
+  // thread until the recording is written
+  thread_local std::shared_ptr<ThreadBuffer> buffer;
+  if (!buffer) {
+    buffer = std::make_shared<ThreadBuffer>();
+    std::lock_guard<std::mutex> lock(m_buffersMutex);
+    buffer->threadId = (int)m_buffers.size() + 1;
+    m_buffers.push_back(buffer);
+  }
+  return *buffer;
+}
+
+void Tracer::SetThreadName(const char *name) {
+  ThreadBuffer &buffer = GetThreadBuffer();
+  std::lock_guard<std::mutex> lock(buffer.mutex);
+  buffer.name = name;
+}
+
+void Tracer::AddSpan(const char *name, TraceClock::time_point start,
+                     TraceClock::time_point end) {
+  ThreadBuffer &buffer = GetThreadBuffer();
+  int64_t startNs = toNs(start);
+  std::lock_guard<std::mutex> lock(buffer.mutex);
+  // a span still open when the recording stopped or restarted is dropped
+  if (!m_recording.load(std::memory_order_relaxed) ||
+      startNs < m_sessionStartNs.load(std::memory_order_relaxed)) {
+    return;
+  }
+  if (buffer.events.size() >= TRACE_MAX_EVENTS_PER_THREAD) {
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  buffer.events.push_back({name, startNs, toNs(end) - startNs});
+}
+
+void Tracer::Start(const std::string &filename) {
+  m_filename = filename;
+  m_dropped.store(0, std::memory_order_relaxed);
+  m_sessionStartNs.store(toNs(TraceClock::now()), std::memory_order_relaxed);
+
+  std::lock_guard<std::mutex> lock(m_buffersMutex);
+  for (const std::shared_ptr<ThreadBuffer> &buffer : m_buffers) {
+    std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+    buffer->events.clear();
+  }
+  m_recording.store(true, std::memory_order_relaxed);
+}
+
+size_t Tracer::GetEventCount() const {
+  size_t count = 0;
+  std::lock_guard<std::mutex> lock(m_buffersMutex);
+  for (const std::shared_ptr<ThreadBuffer> &buffer : m_buffers) {
+    std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+    count += buffer->events.size();
+  }
+  return count;
+}
+
+// span names are identifiers like "Game::drawFrame", but stay valid JSON
+static void appendJsonString(std::string &out, const char *text) {
+  out += '"';
+  for (const char *c = text; *c; c++) {
+    if (*c == '"' || *c == '\\') {
+      out += '\\';
+      out += *c;
+    } else if ((unsigned char)*c >= 0x20) {
+      out += *c;
+    }
+  }
+  out += '"';
+}
+
+bool Tracer::Stop() {
+  if (!m_recording.exchange(false)) {
+    return false;
+  }
+  int64_t sessionStart = m_sessionStartNs.load(std::memory_order_relaxed);
+
+  // take every thread's spans, the threads keep running meanwhile
+  struct ThreadSpans {
+    int threadId;
+    const char *name;
+    std::vector<Event> events;
+  };
+  std::vector<ThreadSpans> threads;
+  {
+    std::lock_guard<std::mutex> lock(m_buffersMutex);
+    for (const std::shared_ptr<ThreadBuffer> &buffer : m_buffers) {
+      std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+      threads.push_back({buffer->threadId, buffer->name, {}});
+      threads.back().events.swap(buffer->events);
+    }
+  }
+
+  std::ofstream file(m_filename, std::ios::out | std::ios::trunc);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  // trace_event format: complete ("X") events with microsecond timestamps
+  // relative to the start of the recording, plus thread name metadata
+  std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+                    "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+                    "\"tid\":0,\"args\":{\"name\":\"TicTacToe\"}}";
+  char numbers[96];
+  for (const ThreadSpans &thread : threads) {
+    if (thread.name) {
+      snprintf(numbers, sizeof(numbers),
+               ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+               "\"tid\":%d,\"args\":{\"name\":",
+               thread.threadId);
+      out += numbers;
+      appendJsonString(out, thread.name);
+      out += "}}";
+    }
+    for (const Event &event : thread.events) {
+      out += ",\n{\"name\":";
+      appendJsonString(out, event.name);
+      snprintf(numbers, sizeof(numbers),
+               ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+               thread.threadId, (double)(event.startNs - sessionStart) / 1e3,
+               (double)event.durationNs / 1e3);
+      out += numbers;
+    }
+    // keep the file writes out of the way of a large recording's memory
+    if (out.size() > (1 << 20)) {
+      file << out;
+      out.clear();
+    }
+  }
+  out += "\n]}\n";
+  file << out;
+  return file.good();
+}
+
+} // namespace ClassGame
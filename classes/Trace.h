@@ -0,0 +1,141 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ClassGame {
+
+//
+// Scoped timing spans written as a Chrome trace_event JSON file, which opens
+// in Perfetto (ui.perfetto.dev) or chrome://tracing
+//
+//   void Game::drawFrame() {
+//     TRACE_SCOPE("Game::drawFrame");
+//     ...
+//   }
+//
+// While no trace is being recorded a span is one relaxed atomic load. While
+// recording, every thread appends to its own buffer, so threads never wait
+// on each other; the buffers are only gathered when the trace is stopped.
+// Span names must be string literals (or otherwise outlive the recording).
+//
+
+using TraceClock = std::chrono::steady_clock;
+
+// Spans kept per thread and recording, ~24 MB; later ones are counted as
+// dropped
+const size_t TRACE_MAX_EVENTS_PER_THREAD = 1 << 20;
+
+class Tracer {
+public:
+  // Singleton pattern, like Logger
+  static Tracer &GetInstance();
+
+  Tracer(const Tracer &) = delete;
+  Tracer &operator=(const Tracer &) = delete;
+
+  // Begin a new recording that Stop() writes to filename, discarding
+  // anything still buffered from an earlier one
+  void Start(const std::string &filename);
+  // End the recording and write the file; false if it could not be written
+  bool Stop();
+  bool IsRecording() const {
+    return m_recording.load(std::memory_order_relaxed);
+  }
+
+  // Name the calling thread in the trace, e.g. "AI worker"
+  void SetThreadName(const char *name);
+
+  // Spans recorded so far in the current recording, for display
+  size_t GetEventCount() const;
+  // Spans dropped because a thread's buffer was full
+  uint64_t GetDroppedCount() const {
+    return m_dropped.load(std::memory_order_relaxed);
+  }
+
+  // Called by TraceSpan
+  void AddSpan(const char *name, TraceClock::time_point start,
+               TraceClock::time_point end);
+
+private:
+  Tracer() = default;
+
+  struct Event {
+    const char *name;
+    int64_t startNs;
+    int64_t durationNs;
+  };
+
+  // One per thread that has ever recorded a span. The owning thread is the
+  // only writer, the mutex is taken uncontended except while Start/Stop
+  // sweep the buffers.
+  struct ThreadBuffer {
+    std::mutex mutex;
+    std::vector<Event> events;
+    const char *name = nullptr;
+    int threadId = 0;
+  };
+
+  ThreadBuffer &GetThreadBuffer();
+
+  std::atomic<bool> m_recording{false};
+  std::atomic<uint64_t> m_dropped{0};
+  // spans that began before the current recording are ignored
+  std::atomic<int64_t> m_sessionStartNs{0};
+  std::string m_filename;
+
+  // guards the buffer list, not the buffers' contents
+  mutable std::mutex m_buffersMutex;
+  std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+};
+
+// RAII span: measures from construction to destruction if a trace is being
+// recorded when it starts
+class TraceSpan {
+public:
+  explicit TraceSpan(const char *name) : m_name(nullptr) {
+    if (Tracer::GetInstance().IsRecording()) {
+      m_name = name;
+      m_start = TraceClock::now();
+    }
+  }
+  ~TraceSpan() {
+    if (m_name) {
+      Tracer::GetInstance().AddSpan(m_name, m_start, TraceClock::now());
+    }
+  }
+
+  TraceSpan(const TraceSpan &) = delete;
+  TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+  const char *m_name;
+  TraceClock::time_point m_start;
+};
+
+} // namespace ClassGame
+
+//
+// TRACE_SCOPE(name) times the rest of the enclosing block. Define
+// TRACE_ENABLED to 0 to compile every span out.
+//
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 1
+#endif
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#if TRACE_ENABLED
+#define TRACE_SCOPE(name)                                                      \
+  ::ClassGame::TraceSpan TRACE_CONCAT(traceSpan_, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name)                                                      \
+  do {                                                                         \
+  } while (0)
+#endif
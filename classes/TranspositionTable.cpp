@@ -0,0 +1,65 @@
+#include "TranspositionTable.h"
+
+//
+// keys are 19 bits (18 for the board, 1 for the side to move); the stored key
+// is offset by one so a zeroed slot never matches a real position
+//
+static uint32_t tableKey(const TicTacToeBoard &canonical, int player) {
+  return (canonical.key() | ((uint32_t)player << 18)) + 1;
+}
+
+TranspositionTable::TranspositionTable(size_t entryCount)
+    : _mask(0), _hits(0), _misses(0) {
+  size_t size = 1;
+  while (size < entryCount) {
+    size <<= 1;
+  }
+  _entries.resize(size);
+  _mask = size - 1;
+}
+
+size_t TranspositionTable::slotFor(uint32_t key) const {
+  // multiplicative hash, the raw key clusters in the low bits
+  return (size_t)((key * 2654435761u) >> 7) & _mask;
+}
+
+bool TranspositionTable::probe(const TicTacToeBoard &board, int player,
+                               int &score, TTBound &bound, int &bestMove) {
+  int symmetry = 0;
+  TicTacToeBoard canonical = canonicalBoard(board, symmetry);
+  uint32_t key = tableKey(canonical, player);
+
+  const TTEntry &entry = _entries[slotFor(key)];
+  if (entry.key != key) {
+    _misses++;
+    return false;
+  }
+
+  _hits++;
+  score = entry.score;
+  bound = entry.bound;
+  bestMove = entry.bestMove >= 0 ? squareFromCanonical(entry.bestMove, symmetry)
+                                 : -1;
+  return true;
+}
+
+void TranspositionTable::store(const TicTacToeBoard &board, int player,
+                               int score, TTBound bound, int bestMove) {
+  int symmetry = 0;
+  TicTacToeBoard canonical = canonicalBoard(board, symmetry);
+  uint32_t key = tableKey(canonical, player);
+
+  TTEntry &entry = _entries[slotFor(key)];
+  entry.key = key;
+  entry.score = (int8_t)score;
+  entry.bound = bound;
+  entry.bestMove =
+      (int8_t)(bestMove >= 0 ? kBoardSymmetries[symmetry][bestMove] : -1);
+}
+
+void TranspositionTable::clear() {
+  for (TTEntry &entry : _entries) {
+    entry = TTEntry();
+  }
+  resetStats();
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "TicTacToeBoard.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//
+// transposition table for the tic-tac-toe search
+//
+// positions are stored under their canonical form (see canonicalBoard) so
+// every rotation and reflection of a position shares one slot. the best move
+// is kept in canonical coordinates and mapped back on lookup.
+//
+
+enum class TTBound : uint8_t { None, Exact, Lower, Upper };
+
+struct TTEntry {
+  uint32_t key = 0;   // canonical board key plus side to move
+  int8_t score = 0;   // score relative to this node (no ply adjustment)
+  TTBound bound = TTBound::None;
+  int8_t bestMove = -1; // square on the canonical board
+};
+
+class TranspositionTable {
+public:
+  // entryCount is rounded up to a power of two
+  explicit TranspositionTable(size_t entryCount);
+
+  // look a position up. on a hit score, bound and bestMove (in the caller's
+  // orientation) are filled in and true is returned.
+  bool probe(const TicTacToeBoard &board, int player, int &score,
+             TTBound &bound, int &bestMove);
+  // store a search result for a position, always replacing the slot
+  void store(const TicTacToeBoard &board, int player, int score,
+             TTBound bound, int bestMove);
+
+  void clear();
+  size_t size() const { return _entries.size(); }
+
+  // probe statistics since construction or the last resetStats()
+  uint64_t hits() const { return _hits; }
+  uint64_t misses() const { return _misses; }
+  void resetStats() { _hits = _misses = 0; }
+
+private:
+  size_t slotFor(uint32_t key) const;
+
+  std::vector<TTEntry> _entries;
+  size_t _mask;
+  uint64_t _hits;
+  uint64_t _misses;
+};
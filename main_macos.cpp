@@ -17,6 +17,9 @@
 #endif
 #include <GLFW/glfw3.h> // Will drag system OpenGL headers
 #include "Application.h"
+#include "classes/Metrics.h"
+#include "classes/Trace.h"
+#include <chrono>
 
 // [Win32] Our example includes a copy of glfw3.lib pre-compiled with VS2010 to maximize ease of testing and compatibility with old VS compilers.
 // To link with VS2010-era libraries, VS2015+ requires linking with legacy_stdio_definitions.lib, which we do using this pragma.
@@ -35,6 +38,10 @@ static void glfw_error_callback(int error, const char* description)
     fprintf(stderr, "GLFW Error %d: %s\n", error, description);
 }
 
+// set by the input callbacks installed in main, which the ImGui backend calls
+// after handling the event itself; the render loop clears it
+static bool g_InputArrived = false;
+
 // Main code
 int main(int, char**)
 {
@@ -96,7 +103,17 @@ int main(int, char**)
     }
 
     // Setup Platform/Renderer backends
+    // our input callbacks go in first so the backend chains to them, for the
+    // platform windows of other viewports too
+    glfwSetWindowFocusCallback(window, [](GLFWwindow*, int) { g_InputArrived = true; });
+    glfwSetCursorEnterCallback(window, [](GLFWwindow*, int) { g_InputArrived = true; });
+    glfwSetCursorPosCallback(window, [](GLFWwindow*, double, double) { g_InputArrived = true; });
+    glfwSetMouseButtonCallback(window, [](GLFWwindow*, int, int, int) { g_InputArrived = true; });
+    glfwSetScrollCallback(window, [](GLFWwindow*, double, double) { g_InputArrived = true; });
+    glfwSetKeyCallback(window, [](GLFWwindow*, int, int, int, int) { g_InputArrived = true; });
+    glfwSetCharCallback(window, [](GLFWwindow*, unsigned int) { g_InputArrived = true; });
     ImGui_ImplGlfw_InitForOpenGL(window, true);
+    ImGui_ImplGlfw_SetCallbacksChainForAllWindows(true);
     ImGui_ImplOpenGL3_Init(glsl_version);
 
     // Load Fonts
@@ -121,6 +138,28 @@ int main(int, char**)
     bool show_another_window = false;
     ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
     ClassGame::GameStartUp();
+
+    // frame-to-frame time covers the whole loop, vsync waits included. a frame
+    // that follows a power-saving wait isn't timed, the wait is not frame cost.
+    ClassGame::Metrics& metrics = ClassGame::Metrics::GetInstance();
+    ClassGame::LatencyHistogram& frameTime = metrics.GetHistogram("frame_seconds", "Time between the starts of consecutive frames, idle waits left out");
+    ClassGame::Counter& frames = metrics.GetCounter("frames_total", "Frames rendered");
+    ClassGame::Gauge& frameRate = metrics.GetGauge("frames_per_second", "Running frame rate while drawing, idle waits left out");
+    ClassGame::Gauge& framesPerMinute = metrics.GetGauge("frames_per_minute", "Frames rendered over the last 10 s, per minute; low while idle");
+    auto lastFrame = std::chrono::steady_clock::now();
+    double averageFrameNs = 0.0;
+    auto rateWindowStart = lastFrame;
+    uint64_t rateWindowFrames = 0;
+
+    // power saving: after a few frames with no input and nothing changing
+    // (ClassGame::NeedsRedraw), wait for input instead of drawing every vsync.
+    // the extra frames let ImGui settle hover and fade effects, and the wait
+    // still times out now and then for log lines from other threads and timers.
+    const int IDLE_FRAMES_BEFORE_WAIT = 3;
+    const int IDLE_WAIT_MS = 500;
+    int idleFrames = 0;
+    int lastDisplayW = 0, lastDisplayH = 0;
+    ClassGame::Tracer::GetInstance().SetThreadName("main");
     
     // Main loop
 #ifdef __EMSCRIPTEN__
@@ -137,7 +176,43 @@ int main(int, char**)
         // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application, or clear/overwrite your copy of the mouse data.
         // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application, or clear/overwrite your copy of the keyboard data.
         // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
-        glfwPollEvents();
+        bool waitedForInput = false;
+#ifndef __EMSCRIPTEN__
+        if (idleFrames >= IDLE_FRAMES_BEFORE_WAIT)
+        {
+            glfwWaitEventsTimeout(IDLE_WAIT_MS / 1000.0);
+            waitedForInput = true;
+        }
+        else
+#endif
+            glfwPollEvents();
+        // any input brings back the full frame rate straight away
+        if (g_InputArrived)
+        {
+            g_InputArrived = false;
+            idleFrames = 0;
+        }
+
+        auto frameStart = std::chrono::steady_clock::now();
+        if (!waitedForInput)
+        {
+            uint64_t frameNs = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(frameStart - lastFrame).count();
+            frameTime.Record(frameNs);
+            averageFrameNs = averageFrameNs > 0.0 ? averageFrameNs * 0.95 + frameNs * 0.05 : (double)frameNs;
+            frameRate.Set(1e9 / averageFrameNs);
+        }
+        lastFrame = frameStart;
+        frames.Add();
+        rateWindowFrames++;
+        if (frameStart - rateWindowStart >= std::chrono::seconds(10))
+        {
+            double seconds = std::chrono::duration<double>(frameStart - rateWindowStart).count();
+            framesPerMinute.Set((double)rateWindowFrames * 60.0 / seconds);
+            rateWindowStart = frameStart;
+            rateWindowFrames = 0;
+        }
+        metrics.Tick();
+        TRACE_SCOPE("Frame");
 
         // Start the Dear ImGui frame
         ImGui_ImplOpenGL3_NewFrame();
@@ -147,13 +222,25 @@ int main(int, char**)
         ClassGame::RenderGame();
 
         // Rendering
-        ImGui::Render();
+        {
+            TRACE_SCOPE("ImGui::Render");
+            ImGui::Render();
+        }
         int display_w, display_h;
         glfwGetFramebufferSize(window, &display_w, &display_h);
+        if (display_w != lastDisplayW || display_h != lastDisplayH)
+        {
+            lastDisplayW = display_w;
+            lastDisplayH = display_h;
+            idleFrames = 0;
+        }
         glViewport(0, 0, display_w, display_h);
         glClearColor(clear_color.x * clear_color.w, clear_color.y * clear_color.w, clear_color.z * clear_color.w, clear_color.w);
         glClear(GL_COLOR_BUFFER_BIT);
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        {
+            TRACE_SCOPE("RenderDrawData");
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
 
         // Update and Render additional Platform Windows
         // (Platform functions may change the current OpenGL context, so we save/restore it to make it easier to paste this code elsewhere.
@@ -167,6 +254,7 @@ int main(int, char**)
         }
 
         glfwSwapBuffers(window);
+        idleFrames = ClassGame::NeedsRedraw() ? 0 : idleFrames + 1;
     }
 #ifdef __EMSCRIPTEN__
     EMSCRIPTEN_MAINLOOP_END;
@@ -12,6 +12,9 @@
 #include <d3d11.h>
 #include <tchar.h>
 #include "Application.h"
+#include "classes/Metrics.h"
+#include "classes/Trace.h"
+#include <chrono>
 
 // Data
 ID3D11Device*            g_pd3dDevice = nullptr;
@@ -108,6 +111,29 @@ int main(int, char**)
     // Our state
     ClassGame::GameStartUp();
 
+    // frame-to-frame time covers the whole loop, vsync waits included. a frame
+    // that follows a power-saving wait isn't timed, the wait is not frame cost.
+    ClassGame::Metrics& metrics = ClassGame::Metrics::GetInstance();
+    ClassGame::LatencyHistogram& frameTime = metrics.GetHistogram("frame_seconds", "Time between the starts of consecutive frames, idle waits left out");
+    ClassGame::Counter& frames = metrics.GetCounter("frames_total", "Frames rendered");
+    ClassGame::Gauge& frameRate = metrics.GetGauge("frames_per_second", "Running frame rate while drawing, idle waits left out");
+    ClassGame::Gauge& framesPerMinute = metrics.GetGauge("frames_per_minute", "Frames rendered over the last 10 s, per minute; low while idle");
+    auto lastFrame = std::chrono::steady_clock::now();
+    double averageFrameNs = 0.0;
+    auto rateWindowStart = lastFrame;
+    uint64_t rateWindowFrames = 0;
+
+    // power saving: after a few frames with no input and nothing changing
+    // (ClassGame::NeedsRedraw), wait for input instead of drawing every vsync.
+    // the extra frames let ImGui settle hover and fade effects, and the wait
+    // still times out now and then for log lines from other threads and timers.
+    const int IDLE_FRAMES_BEFORE_WAIT = 3;
+    const int IDLE_WAIT_MS = 500;
+    int idleFrames = 0;
+    // the next frame comes after a wait or a sleep and isn't timed
+    bool waitedForInput = false;
+    ClassGame::Tracer::GetInstance().SetThreadName("main");
+
     // Main loop
     bool done = false;
     while (!done)
@@ -115,8 +141,19 @@ int main(int, char**)
         // Poll and handle messages (inputs, window resize, etc.)
         // See the WndProc() function below for our to dispatch events to the Win32 backend.
         MSG msg;
+        if (idleFrames >= IDLE_FRAMES_BEFORE_WAIT)
+        {
+            ::MsgWaitForMultipleObjects(0, nullptr, FALSE, IDLE_WAIT_MS, QS_ALLINPUT);
+            waitedForInput = true;
+        }
         while (::PeekMessage(&msg, nullptr, 0U, 0U, PM_REMOVE))
         {
+            // any input, to this window or a viewport's, brings back the full
+            // frame rate straight away
+            if ((msg.message >= WM_KEYFIRST && msg.message <= WM_KEYLAST) ||
+                (msg.message >= WM_MOUSEFIRST && msg.message <= WM_MOUSELAST) ||
+                msg.message == WM_MOUSELEAVE)
+                idleFrames = 0;
             ::TranslateMessage(&msg);
             ::DispatchMessage(&msg);
             if (msg.message == WM_QUIT)
@@ -129,6 +166,7 @@ int main(int, char**)
         if (g_SwapChainOccluded && g_pSwapChain->Present(0, DXGI_PRESENT_TEST) == DXGI_STATUS_OCCLUDED)
         {
             ::Sleep(10);
+            waitedForInput = true;
             continue;
         }
         g_SwapChainOccluded = false;
@@ -140,7 +178,30 @@ int main(int, char**)
             g_pSwapChain->ResizeBuffers(0, g_ResizeWidth, g_ResizeHeight, DXGI_FORMAT_UNKNOWN, 0);
             g_ResizeWidth = g_ResizeHeight = 0;
             CreateRenderTarget();
+            idleFrames = 0;
+        }
+
+        auto frameStart = std::chrono::steady_clock::now();
+        if (!waitedForInput)
+        {
+            uint64_t frameNs = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(frameStart - lastFrame).count();
+            frameTime.Record(frameNs);
+            averageFrameNs = averageFrameNs > 0.0 ? averageFrameNs * 0.95 + frameNs * 0.05 : (double)frameNs;
+            frameRate.Set(1e9 / averageFrameNs);
         }
+        waitedForInput = false;
+        lastFrame = frameStart;
+        frames.Add();
+        rateWindowFrames++;
+        if (frameStart - rateWindowStart >= std::chrono::seconds(10))
+        {
+            double seconds = std::chrono::duration<double>(frameStart - rateWindowStart).count();
+            framesPerMinute.Set((double)rateWindowFrames * 60.0 / seconds);
+            rateWindowStart = frameStart;
+            rateWindowFrames = 0;
+        }
+        metrics.Tick();
+        TRACE_SCOPE("Frame");
 
         // Start the Dear ImGui frame
         ImGui_ImplDX11_NewFrame();
@@ -149,11 +210,17 @@ int main(int, char**)
         ClassGame::RenderGame();
 
         // Rendering
-        ImGui::Render();
+        {
+            TRACE_SCOPE("ImGui::Render");
+            ImGui::Render();
+        }
         const float clear_color_with_alpha[4] = { clear_color.x * clear_color.w, clear_color.y * clear_color.w, clear_color.z * clear_color.w, clear_color.w };
         g_pd3dDeviceContext->OMSetRenderTargets(1, &g_mainRenderTargetView, nullptr);
         g_pd3dDeviceContext->ClearRenderTargetView(g_mainRenderTargetView, clear_color_with_alpha);
-        ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+        {
+            TRACE_SCOPE("RenderDrawData");
+            ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+        }
 
         // Update and Render additional Platform Windows
         if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
@@ -164,6 +231,7 @@ int main(int, char**)
 
         // Present
         HRESULT hr = g_pSwapChain->Present(1, 0);   // Present with vsync
+        idleFrames = ClassGame::NeedsRedraw() ? 0 : idleFrames + 1;
         //HRESULT hr = g_pSwapChain->Present(0, 0); // Present without vsync
         g_SwapChainOccluded = (hr == DXGI_STATUS_OCCLUDED);
     }
@@ -0,0 +1,48 @@
+//
+// bakes the PNGs in a directory into a prebaked asset bundle
+//
+// the images are decoded and packed into atlas pages exactly as
+// TextureCache::buildAtlas does at runtime, then written out in the bundle
+// layout described in classes/AssetBundle.h. the build runs this next to the
+// resources copy so the game can map the bundle instead of decoding PNGs.
+//
+// usage: assetbake RESOURCE_DIR OUTPUT_BUNDLE
+//
+
+#include "../classes/AssetBundle.h"
+#include "../classes/TextureAtlas.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "../classes/stb_image.h"
+
+#include <cstdio>
+
+int main(int argc, char **argv) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: assetbake RESOURCE_DIR OUTPUT_BUNDLE\n");
+    return 2;
+  }
+
+  std::vector<AtlasImage> images = loadAtlasImages(argv[1]);
+  TextureAtlas atlas;
+  int packed = atlas.build(images, TEXTURE_ATLAS_PAGE_SIZE);
+  if (packed < (int)images.size()) {
+    fprintf(stderr,
+            "assetbake: %d images too big for a %d px page, they will load "
+            "from their PNGs\n",
+            (int)images.size() - packed, TEXTURE_ATLAS_PAGE_SIZE);
+  }
+
+  if (!AssetBundle::write(argv[2], atlas)) {
+    fprintf(stderr, "assetbake: could not write %s\n", argv[2]);
+    return 1;
+  }
+
+  size_t bytes = 0;
+  for (const AtlasPage &page : atlas.pages()) {
+    bytes += page.pixels.size();
+  }
+  printf("assetbake: %d images on %zu pages (%zu KB) -> %s\n", packed,
+         atlas.pages().size(), bytes / 1024, argv[2]);
+  return 0;
+}
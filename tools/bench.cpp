@@ -0,0 +1,260 @@
+//
+// micro-benchmarks for the game core hot paths
+//
+// runs without a window or graphics backend: sprites still decode their
+// PNGs but get a dummy texture (SPRITE_HEADLESS). each benchmark is warmed
+// up, then timed over several repetitions; the median is reported as ns/op
+// together with heap allocations per op.
+//
+// a human readable table goes to stderr and a JSON document to stdout, so
+// two builds can be compared with e.g. `bench > before.json`.
+//
+// usage: bench [--warmup N] [--reps N] [--filter SUBSTRING]
+//
+
+#include "../classes/TicTacToe.h"
+#include "../classes/TicTacToeAI.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+//
+// count every heap allocation made by the process
+//
+static std::atomic<uint64_t> g_allocations{0};
+
+void *operator new(size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t) noexcept { std::free(p); }
+
+//
+// Game::endTurn reports back to the application shell, which the bench
+// doesn't have
+//
+namespace ClassGame {
+void EndOfTurn() {}
+} // namespace ClassGame
+
+// keeps the optimizer from dropping work whose result is unused
+static volatile uint64_t g_sink = 0;
+static void consume(uint64_t value) { g_sink = g_sink + value; }
+
+struct BenchConfig {
+  int warmup = 3;
+  int reps = 10;
+  const char *filter = nullptr;
+};
+
+struct BenchResult {
+  std::string name;
+  uint64_t opsPerRep = 0;
+  int reps = 0;
+  double nsPerOp = 0;    // median over repetitions
+  double minNsPerOp = 0; // fastest repetition
+  double allocsPerOp = 0;
+};
+
+//
+// run body(ops) warmup + reps times, body must perform ops operations.
+// setup() runs before every pass, outside the timed region.
+//
+template <typename Setup, typename Body>
+static void runBench(const BenchConfig &config, const char *name,
+                     uint64_t ops, std::vector<BenchResult> &results,
+                     Setup setup, Body body) {
+  if (config.filter && !strstr(name, config.filter)) {
+    return;
+  }
+
+  for (int i = 0; i < config.warmup; i++) {
+    setup();
+    body(ops);
+  }
+
+  std::vector<double> samples;
+  uint64_t allocations = 0;
+  for (int i = 0; i < config.reps; i++) {
+    setup();
+    uint64_t allocsBefore = g_allocations.load(std::memory_order_relaxed);
+    auto start = std::chrono::steady_clock::now();
+    body(ops);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    allocations += g_allocations.load(std::memory_order_relaxed) - allocsBefore;
+    samples.push_back(
+        (double)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+            .count() /
+        (double)ops);
+  }
+  std::sort(samples.begin(), samples.end());
+
+  BenchResult result;
+  result.name = name;
+  result.opsPerRep = ops;
+  result.reps = config.reps;
+  result.nsPerOp = samples[samples.size() / 2];
+  result.minNsPerOp = samples.front();
+  result.allocsPerOp =
+      (double)allocations / (double)(ops * (uint64_t)config.reps);
+  results.push_back(result);
+
+  fprintf(stderr, "%-28s %14.1f ns/op %14.1f min %10.2f allocs/op\n", name,
+          result.nsPerOp, result.minNsPerOp, result.allocsPerOp);
+}
+
+template <typename Body>
+static void runBench(const BenchConfig &config, const char *name,
+                     uint64_t ops, std::vector<BenchResult> &results,
+                     Body body) {
+  runBench(config, name, ops, results, []() {}, body);
+}
+
+// random positions from real play: alternating moves, stopping at a win
+static std::vector<TicTacToeBoard> randomBoards(size_t count) {
+  std::mt19937 rng(12345);
+  std::vector<TicTacToeBoard> boards;
+  boards.reserve(count);
+  while (boards.size() < count) {
+    TicTacToeBoard board;
+    int player = 0;
+    int plies = (int)(rng() % 10);
+    for (int ply = 0; ply < plies && checkWinnerOnBoard(board) < 0; ply++) {
+      int move;
+      do {
+        move = (int)(rng() % 9);
+      } while (!board.isEmpty(move));
+      board.place(move, player);
+      player = 1 - player;
+    }
+    boards.push_back(board);
+  }
+  return boards;
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: bench [--warmup N] [--reps N] [--filter SUBSTRING]\n");
+}
+
+int main(int argc, char **argv) {
+  BenchConfig config;
+  for (int i = 1; i < argc; i++) {
+    if (i + 1 >= argc) {
+      usage();
+      return 2;
+    }
+    if (strcmp(argv[i], "--warmup") == 0) {
+      config.warmup = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--reps") == 0) {
+      config.reps = std::max(1, atoi(argv[++i]));
+    } else if (strcmp(argv[i], "--filter") == 0) {
+      config.filter = argv[++i];
+    } else {
+      usage();
+      return 2;
+    }
+  }
+
+  std::vector<BenchResult> results;
+
+  // --- search -------------------------------------------------------------
+  runBench(config, "negamaxBoard/empty", 1, results, [](uint64_t ops) {
+    for (uint64_t i = 0; i < ops; i++) {
+      TicTacToeBoard board;
+      uint64_t nodes = 0;
+      consume((uint64_t)negamaxBoard(board, 0, nodes) + nodes);
+    }
+  });
+
+  runBench(config, "alphaBetaBoard/empty", 100, results, [](uint64_t ops) {
+    for (uint64_t i = 0; i < ops; i++) {
+      TicTacToeBoard board;
+      uint64_t nodes = 0;
+      int score = alphaBetaBoard(board, 0, 0, -kAIWinScore - 1,
+                                 kAIWinScore + 1, nodes);
+      consume((uint64_t)score + nodes);
+    }
+  });
+
+  std::vector<TicTacToeBoard> boards = randomBoards(4096);
+  runBench(config, "checkWinnerOnBoard", 1 << 20, results,
+           [&boards](uint64_t ops) {
+             uint64_t sum = 0;
+             for (uint64_t i = 0; i < ops; i++) {
+               sum += (uint64_t)checkWinnerOnBoard(boards[i & 4095]);
+             }
+             consume(sum);
+           });
+
+  // --- live game ----------------------------------------------------------
+  TicTacToe game;
+  game.setUpBoard();
+  game.setStateString("120210000");
+
+  runBench(config, "TicTacToe::stateString", 100000, results,
+           [&game](uint64_t ops) {
+             for (uint64_t i = 0; i < ops; i++) {
+               consume(game.stateString().size());
+             }
+           });
+
+  runBench(config, "TicTacToe::setStateString", 1000, results,
+           [&game](uint64_t ops) {
+             for (uint64_t i = 0; i < ops; i++) {
+               game.setStateString((i & 1) ? "120210000" : "210120000");
+             }
+           });
+
+  runBench(config, "TicTacToe::checkForWinner", 1 << 20, results,
+           [&game](uint64_t ops) {
+             for (uint64_t i = 0; i < ops; i++) {
+               consume((uint64_t)(uintptr_t)game.checkForWinner());
+             }
+           });
+
+  // every endTurn appends to the game's turn history, so each pass starts a
+  // fresh game and plays at most the nine turns a real one can have
+  runBench(
+      config, "Game::endTurn", 9, results,
+      [&game]() {
+        game.stopGame();
+        game.setUpBoard();
+      },
+      [&game](uint64_t ops) {
+        for (uint64_t i = 0; i < ops; i++) {
+          game.endTurn();
+        }
+      });
+  game.stopGame();
+
+  // --- report -------------------------------------------------------------
+  printf("{\n  \"benchmarks\": [\n");
+  for (size_t i = 0; i < results.size(); i++) {
+    const BenchResult &r = results[i];
+    printf("    {\"name\": \"%s\", \"ops_per_rep\": %llu, \"reps\": %d, "
+           "\"ns_per_op\": %.3f, \"min_ns_per_op\": %.3f, "
+           "\"allocs_per_op\": %.4f}%s\n",
+           r.name.c_str(), (unsigned long long)r.opsPerRep, r.reps, r.nsPerOp,
+           r.minNsPerOp, r.allocsPerOp, i + 1 < results.size() ? "," : "");
+  }
+  printf("  ],\n  \"warmup\": %d,\n  \"reps\": %d\n}\n", config.warmup,
+         config.reps);
+  return 0;
+}
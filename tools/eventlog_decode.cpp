@@ -0,0 +1,159 @@
+//
+// decoder for the binary game event log (application.events)
+//
+// prints one line per record, under a line for each session (one per run of
+// the game), or CSV with --csv, numbering the sessions in the first column.
+// the board is shown as nine characters, square 0 first: X, O or '.' for an
+// empty square.
+//
+// usage: eventlog_decode [--csv] FILE
+//
+
+#include "../classes/EventLogFormat.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace ClassGame;
+
+static std::string boardString(uint32_t board) {
+  std::string text(9, '.');
+  for (int i = 0; i < 9; i++) {
+    if (board & (1u << i)) {
+      text[i] = 'X';
+    } else if (board & (1u << (i + 9))) {
+      text[i] = 'O';
+    }
+  }
+  return text;
+}
+
+static void usage() {
+  fprintf(stderr, "usage: eventlog_decode [--csv] FILE\n");
+}
+
+int main(int argc, char **argv) {
+  bool csv = false;
+  const char *path = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--csv") == 0) {
+      csv = true;
+    } else if (!path) {
+      path = argv[i];
+    } else {
+      usage();
+      return 2;
+    }
+  }
+  if (!path) {
+    usage();
+    return 2;
+  }
+
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    fprintf(stderr, "eventlog_decode: can't open %s\n", path);
+    return 1;
+  }
+
+  // records depend on the ones before them, so the file is read whole
+  std::vector<uint8_t> bytes;
+  uint8_t chunk[4096];
+  size_t got;
+  while ((got = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+    bytes.insert(bytes.end(), chunk, chunk + got);
+  }
+  fclose(file);
+
+  if (!IsEventLogHeader(bytes.data(), bytes.size())) {
+    fprintf(stderr, "eventlog_decode: %s is not an event log\n", path);
+    return 1;
+  }
+
+  if (csv) {
+    printf("session,wall_time_ns,time_us,event,level,player,move,board,"
+           "ai_nodes,ai_us\n");
+  }
+
+  // every run of the game appended a session: a header, then records that
+  // only make sense after it
+  uint64_t wallClockNs = 0;
+  EventStreamState state;
+  uint64_t sessions = 0;
+  uint64_t count = 0;
+  size_t offset = 0;
+  bool truncated = false;
+  while (offset < bytes.size()) {
+    const uint8_t *at = bytes.data() + offset;
+    size_t left = bytes.size() - offset;
+    if (IsEventLogHeader(at, left)) {
+      if (left < EVENT_LOG_HEADER_SIZE ||
+          !DecodeEventLogHeader(at, wallClockNs)) {
+        fprintf(stderr,
+                "eventlog_decode: stopped at a session this version can't "
+                "read\n");
+        break;
+      }
+      offset += EVENT_LOG_HEADER_SIZE;
+      state = EventStreamState();
+      sessions++;
+      if (!csv) {
+        printf("session %llu, wall clock %llu ns\n",
+               (unsigned long long)sessions, (unsigned long long)wallClockNs);
+      }
+      continue;
+    }
+
+    GameEventRecord record;
+    size_t used = DecodeEventRecord(at, left, state, record);
+    if (used == 0) {
+      // a run that died mid-write leaves a partial record; the next
+      // session, if any, starts at its header
+      truncated = true;
+      size_t next = offset + 1;
+      while (next < bytes.size() &&
+             !IsEventLogHeader(bytes.data() + next, bytes.size() - next)) {
+        next++;
+      }
+      offset = next;
+      continue;
+    }
+    offset += used;
+    std::string board = boardString(record.board);
+    std::string_view level = LogLevelName(record.level);
+
+    if (csv) {
+      printf("%llu,%llu,%llu,%s,%.*s,%d,%d,%s,%u,%u\n",
+             (unsigned long long)sessions,
+             (unsigned long long)(wallClockNs + record.timeUs * 1000),
+             (unsigned long long)record.timeUs, GetGameEventName(record.id),
+             (int)level.size(), level.data(), record.player, record.move,
+             board.c_str(), record.aiNodes, record.aiMicros);
+    } else {
+      printf("+%.6fs [%.*s] %-12s", (double)record.timeUs / 1e6,
+             (int)level.size(), level.data(), GetGameEventName(record.id));
+      if (record.player >= 0) {
+        printf(" player=%d", record.player);
+      }
+      if (record.move >= 0) {
+        printf(" move=%d", record.move);
+      }
+      printf(" board=%s", board.c_str());
+      if (record.id == GameEventId::AI_MOVE) {
+        printf(" nodes=%u time_us=%u", record.aiNodes, record.aiMicros);
+      }
+      printf("\n");
+    }
+    count++;
+  }
+
+  if (truncated) {
+    fprintf(stderr, "eventlog_decode: ignored a truncated record\n");
+  }
+  fprintf(stderr, "eventlog_decode: %llu records in %llu sessions\n",
+          (unsigned long long)count, (unsigned long long)sessions);
+  return 0;
+}
@@ -0,0 +1,297 @@
+//
+// headless AI-vs-AI tic-tac-toe runner
+//
+// plays games between two AI players on every core with no window, ImGui or
+// textures involved, and reports throughput, results and per-move latency.
+// each worker thread owns its own games and transposition tables, nothing is
+// shared until the totals are merged at the end.
+//
+// with both sides searching to the end of the game, every result is checked
+// against the solved value of the position after the random opening, so a
+// search change that stops playing perfectly shows up as a mismatch (and a
+// non-zero exit code).
+//
+// usage: selfplay [--games N] [--threads N] [--depth N] [--random-plies N]
+//                 [--x-mode MODE] [--o-mode MODE] [--seed N]
+//        MODE is negamax, alphabeta, tt or perfect
+//
+
+#include "../classes/GameOptions.h"
+#include "../classes/Metrics.h"
+#include "../classes/TicTacToeAI.h"
+#include "../classes/TicTacToePerfectPlay.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// transposition table slots for each player in each worker
+const size_t SELFPLAY_TABLE_ENTRIES = 1 << 13;
+
+struct SelfPlayConfig {
+  uint64_t games = 1000000;
+  unsigned threads = 0;
+  int randomPlies = 2;
+  uint64_t seed = 1;
+  AISearchMode modes[2] = {AISearchMode::PerfectTable,
+                           AISearchMode::PerfectTable};
+  GameOptions options = {};
+};
+
+struct SelfPlayTotals {
+  uint64_t games = 0;
+  uint64_t wins[2] = {0, 0};
+  uint64_t draws = 0;
+  uint64_t mismatches = 0;
+  uint64_t nodes = 0;
+  ClassGame::LatencyHistogram latency;
+
+  void merge(const SelfPlayTotals &other) {
+    games += other.games;
+    wins[0] += other.wins[0];
+    wins[1] += other.wins[1];
+    draws += other.draws;
+    mismatches += other.mismatches;
+    nodes += other.nodes;
+    latency.Merge(other.latency);
+  }
+};
+
+//
+// one AI-vs-AI game instance, owned by a single worker thread
+//
+class SelfPlayGame {
+public:
+  explicit SelfPlayGame(const SelfPlayConfig &config)
+      : _config(config), _options(config.options),
+        _tables{TranspositionTable(SELFPLAY_TABLE_ENTRIES),
+                TranspositionTable(SELFPLAY_TABLE_ENTRIES)} {}
+
+  // play one game to the end and add it to totals
+  void play(std::mt19937_64 &rng, SelfPlayTotals &totals) {
+    TicTacToeBoard board;
+    int player = 0;
+    _options.currentTurnNo = 0;
+
+    // random opening so the runs don't all replay the same game
+    for (int ply = 0; ply < _config.randomPlies; ply++) {
+      if (checkWinnerOnBoard(board) >= 0 || isBoardFull(board)) {
+        break;
+      }
+      int move;
+      do {
+        move = (int)(rng() % 9);
+      } while (!board.isEmpty(move));
+      board.place(move, player);
+      player = 1 - player;
+      _options.currentTurnNo++;
+    }
+
+    bool checkResult = _options.AIMAXDepth == 0 &&
+                       checkWinnerOnBoard(board) < 0 && !isBoardFull(board);
+    int expected = checkResult ? perfectPlayScore(board) : 0;
+    int expectedPlayer = player;
+
+    while (checkWinnerOnBoard(board) < 0 && !isBoardFull(board)) {
+      auto start = std::chrono::steady_clock::now();
+      AISearchResult result =
+          searchBestMove(board, player, _config.modes[player],
+                         &_tables[player], nullptr, _options.AIMAXDepth);
+      auto elapsed = std::chrono::steady_clock::now() - start;
+      _options.AIDepthSearches++;
+
+      totals.latency.Record(
+          (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+              elapsed)
+              .count());
+      totals.nodes += result.nodes;
+
+      board.place(result.move, player);
+      player = 1 - player;
+      _options.currentTurnNo++;
+    }
+
+    int winner = checkWinnerOnBoard(board);
+    totals.games++;
+    if (winner >= 0) {
+      totals.wins[winner]++;
+    } else {
+      totals.draws++;
+    }
+
+    if (checkResult) {
+      int outcome = winner < 0 ? 0 : (winner == expectedPlayer ? 1 : -1);
+      int solved = (expected > 0) - (expected < 0);
+      if (outcome != solved) {
+        totals.mismatches++;
+      }
+    }
+  }
+
+private:
+  const SelfPlayConfig &_config;
+  GameOptions _options;
+  TranspositionTable _tables[2];
+};
+
+static bool parseMode(const char *name, AISearchMode &mode) {
+  if (strcmp(name, "negamax") == 0) {
+    mode = AISearchMode::Negamax;
+  } else if (strcmp(name, "alphabeta") == 0) {
+    mode = AISearchMode::AlphaBeta;
+  } else if (strcmp(name, "tt") == 0) {
+    mode = AISearchMode::AlphaBetaTT;
+  } else if (strcmp(name, "perfect") == 0) {
+    mode = AISearchMode::PerfectTable;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+static const char *modeName(AISearchMode mode) {
+  switch (mode) {
+  case AISearchMode::Negamax:
+    return "negamax";
+  case AISearchMode::AlphaBeta:
+    return "alphabeta";
+  case AISearchMode::AlphaBetaTT:
+    return "tt";
+  case AISearchMode::PerfectTable:
+    return "perfect";
+  }
+  return "unknown";
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: selfplay [--games N] [--threads N] [--depth N] "
+          "[--random-plies N]\n"
+          "                [--x-mode MODE] [--o-mode MODE] [--seed N]\n"
+          "       MODE is negamax, alphabeta, tt or perfect\n");
+}
+
+int main(int argc, char **argv) {
+  SelfPlayConfig config;
+  config.options.AIvsAI = true;
+  config.options.AIPlaying = true;
+  config.options.numberOfPlayers = 2;
+  config.options.rowX = 3;
+  config.options.rowY = 3;
+
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    if (!value) {
+      usage();
+      return 2;
+    }
+    if (strcmp(arg, "--games") == 0) {
+      config.games = strtoull(value, nullptr, 10);
+    } else if (strcmp(arg, "--threads") == 0) {
+      config.threads = (unsigned)atoi(value);
+    } else if (strcmp(arg, "--depth") == 0) {
+      config.options.AIMAXDepth = atoi(value);
+    } else if (strcmp(arg, "--random-plies") == 0) {
+      config.randomPlies = atoi(value);
+    } else if (strcmp(arg, "--seed") == 0) {
+      config.seed = strtoull(value, nullptr, 10);
+    } else if (strcmp(arg, "--x-mode") == 0) {
+      if (!parseMode(value, config.modes[0])) {
+        usage();
+        return 2;
+      }
+    } else if (strcmp(arg, "--o-mode") == 0) {
+      if (!parseMode(value, config.modes[1])) {
+        usage();
+        return 2;
+      }
+    } else {
+      usage();
+      return 2;
+    }
+    i++;
+  }
+
+  if (config.threads == 0) {
+    config.threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  printf("selfplay: %llu games on %u threads, X=%s O=%s, depth %d, "
+         "%d random plies\n",
+         (unsigned long long)config.games, config.threads,
+         modeName(config.modes[0]), modeName(config.modes[1]),
+         config.options.AIMAXDepth, config.randomPlies);
+
+  std::vector<SelfPlayTotals> perThread(config.threads);
+  std::vector<std::thread> workers;
+  auto start = std::chrono::steady_clock::now();
+
+  for (unsigned t = 0; t < config.threads; t++) {
+    uint64_t share = config.games / config.threads +
+                     (t < config.games % config.threads ? 1 : 0);
+    workers.emplace_back([&config, &perThread, t, share] {
+      std::mt19937_64 rng(config.seed * 0x9E3779B97F4A7C15ull + t);
+      SelfPlayGame game(config);
+      // counted locally, the vector packs every thread's totals next to
+      // each other and updating them per move would share cache lines
+      SelfPlayTotals local;
+      for (uint64_t g = 0; g < share; g++) {
+        game.play(rng, local);
+      }
+      perThread[t].merge(local);
+    });
+  }
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+
+  double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+
+  SelfPlayTotals totals;
+  for (const SelfPlayTotals &t : perThread) {
+    totals.merge(t);
+  }
+
+  double games = (double)std::max<uint64_t>(totals.games, 1);
+  printf("games:        %llu in %.3f s (%.0f games/s)\n",
+         (unsigned long long)totals.games, seconds,
+         (double)totals.games / seconds);
+  printf("X wins:       %llu (%.2f%%)\n", (unsigned long long)totals.wins[0],
+         100.0 * (double)totals.wins[0] / games);
+  printf("draws:        %llu (%.2f%%)\n", (unsigned long long)totals.draws,
+         100.0 * (double)totals.draws / games);
+  printf("O wins:       %llu (%.2f%%)\n", (unsigned long long)totals.wins[1],
+         100.0 * (double)totals.wins[1] / games);
+  printf("moves:        %llu, %.1f nodes/move\n",
+         (unsigned long long)totals.latency.Count(),
+         (double)totals.nodes /
+             (double)std::max<uint64_t>(totals.latency.Count(), 1));
+  printf("move latency: p50 %llu ns, p90 %llu ns, p99 %llu ns, "
+         "p99.9 %llu ns, max %llu ns\n",
+         (unsigned long long)totals.latency.Percentile(50.0),
+         (unsigned long long)totals.latency.Percentile(90.0),
+         (unsigned long long)totals.latency.Percentile(99.0),
+         (unsigned long long)totals.latency.Percentile(99.9),
+         (unsigned long long)totals.latency.Max());
+
+  if (config.options.AIMAXDepth == 0) {
+    printf("solved-value mismatches: %llu\n",
+           (unsigned long long)totals.mismatches);
+    if (totals.mismatches > 0) {
+      fprintf(stderr, "selfplay: perfect play did not match the solved "
+                      "result\n");
+      return 1;
+    }
+  }
+  return 0;
+}